@@ -0,0 +1,112 @@
+﻿#ifndef _ByteScan_hpp
+#define _ByteScan_hpp
+
+
+#include <cstddef>
+
+/*
+*  Поиск разделителей в буфере по 16 (SSE2) или 32 (AVX2) байта за раз.
+*  Набор инструкций выбирается при компиляции: AVX2 при -mavx2 (/arch:AVX2), иначе SSE2,
+*  который есть на любом x86-64. На остальных платформах и с STACK_NO_SIMD - скалярный цикл.
+*  Читается только диапазон [first, last), хвост короче вектора досматривается скалярно.
+*  Все функции возвращают указатель на первое совпадение или last, как std::find.
+*/
+#if !defined(STACK_NO_SIMD) && (defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define STACK_SIMD_SCAN
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+const char* findByteScalar(const char* first, const char* last, char value) noexcept; /* Первый value побайтово */
+const char* findEitherScalar(const char* first, const char* last, char a, char b) noexcept; /* Первый a или b побайтово */
+const char* findByte(const char* first, const char* last, char value) noexcept; /* Первый value векторно */
+const char* findEither(const char* first, const char* last, char a, char b) noexcept; /* Первый a или b векторно */
+
+
+inline const char* findByteScalar(const char* first, const char* last, char value) noexcept
+{
+	for (; first != last; ++first)
+		if (*first == value)
+			break;
+	return first;
+}
+
+inline const char* findEitherScalar(const char* first, const char* last, char a, char b) noexcept
+{
+	for (; first != last; ++first)
+		if (*first == a || *first == b)
+			break;
+	return first;
+}
+
+/* Номер младшего установленного бита маски совпадений, mask != 0 */
+inline unsigned countTrailingZeros(unsigned mask) noexcept
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return static_cast<unsigned>(index);
+#else
+	return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline const char* findByte(const char* first, const char* last, char value) noexcept
+{
+#ifdef STACK_SIMD_SCAN
+#ifdef __AVX2__
+	const __m256i wide_needle = _mm256_set1_epi8(value);
+	for (; last - first >= 32; first += 32)
+	{
+		__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+		unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, wide_needle)));
+		if (mask)
+			return first + countTrailingZeros(mask);
+	}
+#endif
+	const __m128i needle = _mm_set1_epi8(value);
+	for (; last - first >= 16; first += 16)
+	{
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+		if (mask)
+			return first + countTrailingZeros(mask);
+	}
+#endif
+	return findByteScalar(first, last, value);
+}
+
+inline const char* findEither(const char* first, const char* last, char a, char b) noexcept
+{
+#ifdef STACK_SIMD_SCAN
+#ifdef __AVX2__
+	const __m256i wide_a = _mm256_set1_epi8(a);
+	const __m256i wide_b = _mm256_set1_epi8(b);
+	for (; last - first >= 32; first += 32)
+	{
+		__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+		__m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, wide_a), _mm256_cmpeq_epi8(chunk, wide_b));
+		unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+		if (mask)
+			return first + countTrailingZeros(mask);
+	}
+#endif
+	const __m128i needle_a = _mm_set1_epi8(a);
+	const __m128i needle_b = _mm_set1_epi8(b);
+	for (; last - first >= 16; first += 16)
+	{
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		__m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, needle_a), _mm_cmpeq_epi8(chunk, needle_b));
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+		if (mask)
+			return first + countTrailingZeros(mask);
+	}
+#endif
+	return findEitherScalar(first, last, a, b);
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,200 @@
+﻿#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ByteScan.hpp"
+#include "PersonKeeper.hpp"
+
+/*
+*  Проверка векторного поиска разделителей против скалярного.
+*  findByte/findEither сравниваются с findByteScalar/findEitherScalar при каждом выравнивании начала
+*  и каждой длине хвоста 0..63, с совпадением на каждой позиции, без совпадения и с совпадением сразу за last.
+*  readPersons на файлах с '\r', пропущенными полями, лишними пробелами и без последнего перевода строки
+*  сравнивается с эталонным разбором на std::string::find.
+*  Вывод разбора без SIMD и с SIMD сравнивается между двумя сборками:
+*      g++ -std=c++17 -DSTACK_NO_SIMD ByteScan_test.cpp -o ByteScan_test_scalar && ./ByteScan_test_scalar --dump scalar.txt
+*      g++ -std=c++17 -mavx2 -fsanitize=address,undefined ByteScan_test.cpp -o ByteScan_test && ./ByteScan_test scalar.txt
+*/
+
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+	if (!condition)
+	{
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+}
+
+/* Все выравнивания 32-байтного вектора и все хвосты короче двух векторов */
+static void testScanners()
+{
+	constexpr std::size_t max_offset = 32;
+	constexpr std::size_t max_length = 64;
+	const char needles[] = { '\n', ' ', '\xD0' }; /* '\xD0' - отрицательный char, первый байт кириллицы в UTF-8 */
+
+	std::vector<char> buffer(max_offset + max_length + 1);
+	for (std::size_t offset = 0; offset < max_offset; ++offset)
+		for (std::size_t length = 0; length < max_length; ++length)
+			for (char needle : needles)
+				for (std::size_t position = 0; position <= length + 1; ++position) /* length - без совпадения, length + 1 - сразу за last */
+				{
+					std::fill(buffer.begin(), buffer.end(), 'x');
+					const char* first = buffer.data() + offset;
+					const char* last = first + length;
+					if (position < length)
+						buffer[offset + position] = needle;
+					if (position + 1 < length) /* Второе совпадение не должно перебить первое */
+						buffer[offset + position + 1] = needle;
+					if (position == length + 1)
+						*const_cast<char*>(last) = needle;
+
+					const std::string where = " at offset " + std::to_string(offset) + ", length " + std::to_string(length)
+						+ ", position " + std::to_string(position);
+					check(findByte(first, last, needle) == findByteScalar(first, last, needle), "findByte" + where);
+					check(findEither(first, last, needle, 'y') == findEitherScalar(first, last, needle, 'y'), "findEither (a)" + where);
+					check(findEither(first, last, 'y', needle) == findEitherScalar(first, last, 'y', needle), "findEither (b)" + where);
+				}
+}
+
+/* Эталонный разбор: строки по '\n', поля по первым двум пробелам, остаток строки - отчество */
+static std::vector<std::string> referenceParse(const std::string& text)
+{
+	std::vector<std::string> records;
+	for (std::size_t pos = 0; pos < text.size();)
+	{
+		std::size_t newline = text.find('\n', pos);
+		if (newline == std::string::npos)
+			newline = text.size();
+		const std::string line = text.substr(pos, newline - pos);
+		pos = newline + 1;
+
+		std::string fields[3];
+		std::size_t start = 0;
+		for (std::size_t field = 0; field < 2 && start <= line.size(); ++field)
+		{
+			std::size_t space = line.find(' ', start);
+			if (space == std::string::npos)
+				space = line.size();
+			fields[field] = line.substr(start, space - start);
+			start = space + 1;
+		}
+		if (start <= line.size())
+			fields[2] = line.substr(start);
+		records.push_back(fields[0] + '|' + fields[1] + '|' + fields[2]);
+	}
+	return records;
+}
+
+static std::vector<std::string> records(const stack<Person>& persons)
+{
+	std::vector<std::string> result;
+	for (const Person& person : persons.getContainer())
+		result.push_back(person.getLastName() + '|' + person.getFirstName() + '|' + person.getPatronymic());
+	return result;
+}
+
+/* Случайный текст из разделителей, ASCII и кириллицы, чтобы поля пересекали границы векторов */
+static std::string randomText(std::uint32_t seed, std::size_t size)
+{
+	const char* pieces[] = { " ", "\n", "\r\n", "a", "bc", "Иван", "  ", "Петрович" };
+	std::string text;
+	while (text.size() < size)
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		text += pieces[seed % (sizeof(pieces) / sizeof(pieces[0]))];
+	}
+	return text;
+}
+
+static std::vector<std::string> fixtures()
+{
+	std::vector<std::string> texts = {
+		"",
+		"Иванов Иван Иванович\r\nПетров Петр\r\nСидоров\r\n",
+		"A\n\nB C\nD E F G\n  \n \n",
+		"Фамилия Имя Отчество",
+		"X Y Z\nlast-line-without-newline",
+		std::string(40, 'a') + ' ' + std::string(33, 'b') + ' ' + std::string(70, 'c') + "\r\n" + std::string(31, 'd')
+	};
+	for (std::uint32_t seed = 1; seed <= 20; ++seed)
+		texts.push_back(randomText(seed, 50 * seed));
+	return texts;
+}
+
+/* Разбирает каждый образец всеми путями чтения; возвращает вывод readPersons(file_name) для сравнения сборок */
+static std::string testReadPersons()
+{
+	const std::string file_name = "ByteScan_test.txt";
+	PersonKeeper& keeper = PersonKeeper::instance();
+	std::string dump;
+
+	const std::vector<std::string> texts = fixtures();
+	for (std::size_t i = 0; i < texts.size(); ++i)
+	{
+		{
+			std::ofstream file(file_name, std::ios::binary);
+			file << texts[i];
+		}
+		const std::vector<std::string> expected = referenceParse(texts[i]);
+		const std::string what = " matches the reference on sample " + std::to_string(i);
+
+		const std::vector<std::string> mapped = records(keeper.readPersons(file_name));
+		check(mapped == expected, "readPersons(file_name)" + what);
+		check(records(keeper.readPersons(file_name, 3)) == expected, "readPersons(file_name, threads)" + what);
+
+		std::fstream fstream(file_name, std::ios::in | std::ios::binary);
+		check(records(keeper.readPersons(fstream)) == expected, "readPersons(fstream)" + what);
+
+		std::istringstream stream(texts[i]);
+		PersonReader reader(stream, 7); /* Маленький буфер - строки рвутся на границе дочитывания */
+		std::vector<std::string> streamed;
+		for (Person person; reader.next(person);)
+			streamed.push_back(person.getLastName() + '|' + person.getFirstName() + '|' + person.getPatronymic());
+		check(streamed == expected, "PersonReader" + what);
+
+		for (const std::string& record : mapped)
+			dump += record + '\n';
+		dump += "--\n";
+	}
+
+	std::remove(file_name.c_str());
+	return dump;
+}
+
+
+int main(int argc, char** argv)
+{
+	testScanners();
+	const std::string dump = testReadPersons();
+
+	if (argc > 2 && std::string(argv[1]) == "--dump") /* Сохраняем вывод этой сборки */
+	{
+		std::ofstream(argv[2], std::ios::binary) << dump;
+	}
+	else if (argc > 1) /* Сравниваем с выводом другой сборки */
+	{
+		std::ifstream file(argv[1], std::ios::binary);
+		std::ostringstream other;
+		other << file.rdbuf();
+		check(file.is_open() && other.str() == dump, std::string("readPersons output matches ") + argv[1]);
+	}
+
+	if (failures)
+		return 1;
+#ifdef STACK_SIMD_SCAN
+	std::cout << "ByteScan_test (SIMD): OK\n";
+#else
+	std::cout << "ByteScan_test (scalar): OK\n";
+#endif
+	return 0;
+}
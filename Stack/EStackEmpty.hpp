@@ -5,6 +5,10 @@
 #include "EStackException.hpp"
 
 
+/*
+*  Исключение пустого стека. Бросается часто (например, при опустошении стека в цикле),
+*  поэтому ничего не выделяет: сообщение - строковая константа, what() отдает указатель на нее.
+*/
 class EStackEmpty final : public EStackException
 {
 public:
@@ -14,12 +18,15 @@ public:
 	EStackEmpty(EStackEmpty&& oth) noexcept;
 	virtual ~EStackEmpty() = default;
 
-	const std::string& what() const noexcept; /* Возвращает строку с ошибкой */
+	const char* what() const noexcept; /* Возвращает строку с ошибкой */
+private:
+
+	static constexpr char message[] = "Stack is empty!\n"; /* Общее сообщение, без инициализации во время выполнения */
 };
 
 
 EStackEmpty::EStackEmpty()
-	: EStackException("Stack is empty!\n")
+	: EStackException() /* Пустая строка базы не выделяет память */
 {}
 
 EStackEmpty::EStackEmpty(const EStackEmpty& oth)
@@ -31,9 +38,9 @@ EStackEmpty::EStackEmpty(EStackEmpty&& oth) noexcept
 {}
 
 
-const std::string& EStackEmpty::what() const noexcept
+const char* EStackEmpty::what() const noexcept
 {
-	return string;
+	return message;
 }
 
 
@@ -0,0 +1,137 @@
+﻿#ifndef _MappedFile_hpp
+#define _MappedFile_hpp
+
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+*  Файл, отображенный в память только для чтения.
+*  Отображение живет, пока жив объект, поэтому указатели и string_view внутрь него
+*  нельзя использовать после уничтожения MappedFile.
+*  Пустой файл не отображается: data() == nullptr, size() == 0.
+*/
+class MappedFile final
+{
+public:
+	/* Конструкторы и деструктор */
+	explicit MappedFile(const std::string& file_name);
+	~MappedFile();
+
+	MappedFile(const MappedFile& oth) = delete;
+	MappedFile(MappedFile&& oth) = delete;
+	MappedFile& operator=(const MappedFile& oth) = delete;
+	MappedFile& operator=(MappedFile&& oth) = delete;
+	/* Методы */
+	const char* data() const noexcept; /* Начало отображения */
+	std::size_t size() const noexcept; /* Размер файла в байтах */
+private:
+
+	const char* begin = nullptr;
+	std::size_t length = 0;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#endif
+};
+
+
+#ifdef _WIN32
+inline MappedFile::MappedFile(const std::string& file_name)
+{
+	file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) /* Проверяем, открыли или нет */
+		throw std::runtime_error("File not found\n");
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size))
+	{
+		CloseHandle(file);
+		throw std::runtime_error("Cannot get file size\n");
+	}
+	length = static_cast<std::size_t>(file_size.QuadPart);
+	if (length == 0)
+		return;
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping)
+		begin = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!begin)
+	{
+		if (mapping)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		throw std::runtime_error("Cannot map file\n");
+	}
+}
+
+inline MappedFile::~MappedFile()
+{
+	if (begin)
+		UnmapViewOfFile(begin);
+	if (mapping)
+		CloseHandle(mapping);
+	CloseHandle(file);
+}
+#else
+inline MappedFile::MappedFile(const std::string& file_name)
+{
+	int fd = ::open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) /* Проверяем, открыли или нет */
+		throw std::runtime_error("File not found\n");
+
+	struct stat info;
+	if (::fstat(fd, &info) != 0)
+	{
+		::close(fd);
+		throw std::runtime_error("Cannot get file size\n");
+	}
+	length = static_cast<std::size_t>(info.st_size);
+	if (length == 0)
+	{
+		::close(fd);
+		return;
+	}
+
+	void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); /* Отображение держит файл само */
+	if (address == MAP_FAILED)
+		throw std::runtime_error("Cannot map file\n");
+
+	::madvise(address, length, MADV_SEQUENTIAL); /* Подсказка ядру читать вперед */
+	begin = static_cast<const char*>(address);
+}
+
+inline MappedFile::~MappedFile()
+{
+	if (begin)
+		::munmap(const_cast<char*>(begin), length);
+}
+#endif
+
+inline const char* MappedFile::data() const noexcept
+{
+	return begin;
+}
+
+inline std::size_t MappedFile::size() const noexcept
+{
+	return length;
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,149 @@
+﻿#ifndef _NamePool_hpp
+#define _NamePool_hpp
+
+
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Person.hpp"
+
+/*
+*  Пул интернированных имен: каждое различное имя хранится один раз и получает компактный id.
+*  id выдаются подряд с нуля и остаются валидными, пока жив пул.
+*  Однопоточный.
+*/
+class NamePool final
+{
+public:
+	using id_type = std::uint32_t;
+
+	/* Конструкторы и деструктор */
+	NamePool() = default;
+	NamePool(const NamePool& oth) = delete; /* Ключи словаря ссылаются на строки пула */
+	NamePool(NamePool&& oth) = default;
+	~NamePool() = default;
+
+	/* Операторы */
+	NamePool& operator=(const NamePool& oth) = delete;
+	NamePool& operator=(NamePool&& oth) = default;
+	/* Методы */
+	id_type intern(std::string_view name); /* Возвращает id имени, при первой встрече добавляет его в пул */
+	std::string_view name(id_type id) const noexcept; /* Возвращает имя по id */
+	std::size_t size() const noexcept; /* Количество различных имен */
+private:
+
+	std::deque<std::string> names{}; /* deque не перемещает элементы при добавлении, поэтому string_view на них стабильны */
+	std::unordered_map<std::string_view, id_type> ids{};
+};
+
+
+/*
+*  Человек, имена которого лежат в NamePool: три id вместо трех std::string.
+*  Имена достаются только вместе с пулом, из которого получены id.
+*/
+class InternedPerson final
+{
+public:
+	/* Конструкторы */
+	InternedPerson() = default;
+	InternedPerson(NamePool::id_type last_name, NamePool::id_type first_name, NamePool::id_type patronymic) noexcept;
+	~InternedPerson() = default;
+
+	/* Методы */
+	NamePool::id_type getLastNameId() const noexcept;
+	NamePool::id_type getFirstNameId() const noexcept;
+	NamePool::id_type getPatronymicId() const noexcept;
+
+	std::string_view getLastName(const NamePool& pool) const noexcept;
+	std::string_view getFirstName(const NamePool& pool) const noexcept;
+	std::string_view getPatronymic(const NamePool& pool) const noexcept;
+
+	Person toPerson(const NamePool& pool) const; /* Собирает обычного Person с собственными строками */
+private:
+
+	NamePool::id_type last_name = 0;
+	NamePool::id_type first_name = 0;
+	NamePool::id_type patronymic = 0;
+};
+
+
+NamePool::id_type NamePool::intern(std::string_view name)
+{
+	auto it = ids.find(name);
+	if (it != ids.end())
+		return it->second;
+
+	if (names.size() > UINT32_MAX)
+		throw std::length_error("Too many distinct names\n");
+
+	const std::string& stored = names.emplace_back(name);
+	try
+	{
+		ids.emplace(std::string_view(stored), static_cast<id_type>(names.size() - 1));
+	}
+	catch (...)
+	{
+		names.pop_back();
+		throw;
+	}
+	return static_cast<id_type>(names.size() - 1);
+}
+
+std::string_view NamePool::name(id_type id) const noexcept
+{
+	return names[id];
+}
+
+std::size_t NamePool::size() const noexcept
+{
+	return names.size();
+}
+
+
+InternedPerson::InternedPerson(NamePool::id_type last_name, NamePool::id_type first_name, NamePool::id_type patronymic) noexcept
+	: last_name(last_name),
+	first_name(first_name),
+	patronymic(patronymic)
+{}
+
+NamePool::id_type InternedPerson::getLastNameId() const noexcept
+{
+	return last_name;
+}
+
+NamePool::id_type InternedPerson::getFirstNameId() const noexcept
+{
+	return first_name;
+}
+
+NamePool::id_type InternedPerson::getPatronymicId() const noexcept
+{
+	return patronymic;
+}
+
+std::string_view InternedPerson::getLastName(const NamePool& pool) const noexcept
+{
+	return pool.name(last_name);
+}
+
+std::string_view InternedPerson::getFirstName(const NamePool& pool) const noexcept
+{
+	return pool.name(first_name);
+}
+
+std::string_view InternedPerson::getPatronymic(const NamePool& pool) const noexcept
+{
+	return pool.name(patronymic);
+}
+
+Person InternedPerson::toPerson(const NamePool& pool) const
+{
+	return Person(std::string(getLastName(pool)), std::string(getFirstName(pool)), std::string(getPatronymic(pool)));
+}
+
+
+#endif
\ No newline at end of file
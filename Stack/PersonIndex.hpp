@@ -0,0 +1,432 @@
+﻿#ifndef _PersonIndex_hpp
+#define _PersonIndex_hpp
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "stack.hpp"
+#include "Person.hpp"
+#include "PersonTable.hpp"
+#include "ByteScan.hpp"
+
+/*
+*  Хеш имени и человека: строка читается по 8 байт, каждое слово перемешивается умножением.
+*  Хеш полного имени - хеши трех полей, сцепленные через перемешивание, поэтому
+*  ("ab", "c", ...) и ("a", "bc", ...) дают разные значения.
+*/
+class PersonHash final
+{
+public:
+	std::size_t operator()(const Person& person) const noexcept; /* Хеш полного имени */
+
+	static std::uint64_t hash(std::string_view name) noexcept; /* Хеш одного поля */
+	static std::uint64_t hash(std::string_view last_name, std::string_view first_name, std::string_view patronymic) noexcept; /* Хеш полного имени */
+	static std::uint64_t combine(std::uint64_t last_name, std::uint64_t first_name, std::uint64_t patronymic) noexcept; /* Хеш полного имени из хешей полей */
+private:
+
+	static constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+
+	static std::uint64_t mix(std::uint64_t state, std::uint64_t word) noexcept;
+};
+
+
+/*
+*  Индекс с открытой адресацией в стиле Swiss table: хранит номера ключей, сами ключи не хранит.
+*  Слоты разбиты на группы по 16, для каждого слота есть байт управления:
+*  empty или младшие 7 бит хеша. Группа проверяется целиком одним сравнением SSE2,
+*  поэтому сравнение ключей вызывается только для слотов с совпавшими 7 битами.
+*  Заполнение не выше 7/8, при заполнении таблица растет вдвое; удаления нет.
+*  Каждый ключ лежит в одном слоте: insert сначала ищет равный, поэтому повторы ключа
+*  не удлиняют цепочки проб, а размер таблицы зависит от числа различных ключей.
+*/
+class SwissIndex final
+{
+public:
+	using row_type = std::uint32_t;
+
+	/* Конструкторы и деструктор */
+	SwissIndex() = default;
+	explicit SwissIndex(std::size_t keys); /* Емкость под keys ключей без роста */
+	~SwissIndex() = default;
+
+	/* Методы */
+	std::size_t size() const noexcept; /* Количество ключей */
+
+	template<typename Equal, typename Rehash>
+	row_type insert(std::uint64_t hash, row_type value, Equal equal, Rehash rehash); /* Номер ключа, для которого equal(номер) истинно; если такого нет, вставляет value; rehash(номер) - хеш вставленного номера для роста */
+	template<typename Equal>
+	bool find(std::uint64_t hash, Equal equal, row_type& value) const; /* Ищет номер ключа, для которого equal(номер) истинно; false, если нет */
+private:
+
+	template<typename Equal>
+	bool locate(std::uint64_t hash, Equal equal, row_type& value, std::size_t& free_slot) const; /* Поиск; free_slot - первый пустой слот цепочки */
+	void place(std::uint64_t hash, row_type value); /* Вставка без поиска равного, место должно быть */
+	template<typename Rehash>
+	void grow(Rehash rehash); /* Переезд в таблицу вдвое больше */
+	void allocate(std::size_t groups); /* Пустая таблица из groups групп */
+
+	static constexpr std::size_t group_size = 16;
+	static constexpr std::int8_t empty = -128; /* Старший бит установлен только у пустого слота */
+
+	static std::int8_t tag(std::uint64_t hash) noexcept; /* Младшие 7 бит хеша */
+	unsigned matchTag(std::size_t group, std::int8_t value) const noexcept; /* Маска слотов группы с байтом value */
+
+	std::vector<std::int8_t> control{};
+	std::vector<row_type> slots{};
+	std::size_t group_mask = 0;
+	std::size_t count = 0;
+};
+
+
+/*
+*  Индекс людей из стека: по любому полю и по полному имени.
+*  Для каждого различного ключа в SwissIndex один слот с номером ключа, строки ключа лежат подряд
+*  в таблице rows[offsets[key], offsets[key + 1]), поэтому частые имена и отчества не удлиняют пробы.
+*  Хранит указатели на элементы контейнера стека, поэтому валиден,
+*  пока стек жив и не изменяется. Поиск возвращает всех людей с таким ключом в порядке контейнера.
+*/
+template<typename Container = std::deque<Person>>
+class PersonIndex final
+{
+public:
+	using Field = PersonTable::Field;
+
+	/* Конструкторы и деструктор */
+	template<typename Check>
+	explicit PersonIndex(const stack<Person, Container, Check>& stack);
+	~PersonIndex() = default;
+
+	/* Методы */
+	std::size_t size() const noexcept; /* Количество проиндексированных людей */
+
+	std::vector<const Person*> find(Field field, std::string_view value) const; /* Все люди, у которых поле равно value */
+	std::vector<const Person*> find(std::string_view last_name, std::string_view first_name,
+		std::string_view patronymic) const; /* Все люди с таким полным именем */
+private:
+
+	using row_type = SwissIndex::row_type;
+
+	/* Различные ключи одного индекса и их строки */
+	struct Keys final
+	{
+		SwissIndex index{};
+		std::vector<row_type> offsets{}; /* Строки ключа key - rows[offsets[key], offsets[key + 1]) */
+		std::vector<row_type> rows{};
+	};
+
+	static std::string_view field(const Person& person, Field field) noexcept;
+
+	static void group(Keys& keys, const std::vector<row_type>& key_of_row, std::size_t distinct); /* Раскладывает строки по distinct ключам */
+	template<typename Equal>
+	std::vector<const Person*> collect(const Keys& keys, std::uint64_t hash, Equal equal) const; /* Все люди ключа, для которого equal(человек) истинно */
+
+	std::vector<const Person*> persons{};
+	Keys keys[4]{}; /* Три поля и полное имя */
+};
+
+
+std::size_t PersonHash::operator()(const Person& person) const noexcept
+{
+	return static_cast<std::size_t>(hash(person.getLastName(), person.getFirstName(), person.getPatronymic()));
+}
+
+std::uint64_t PersonHash::mix(std::uint64_t state, std::uint64_t word) noexcept
+{
+	state = (state ^ word) * multiplier;
+	return state ^ (state >> 32);
+}
+
+std::uint64_t PersonHash::hash(std::string_view name) noexcept
+{
+	std::uint64_t state = name.size() * multiplier;
+	const char* it = name.data();
+	std::size_t rest = name.size();
+	for (; rest >= 8; it += 8, rest -= 8)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, it, 8);
+		state = mix(state, word);
+	}
+	if (rest)
+	{
+		std::uint64_t word = 0;
+		std::memcpy(&word, it, rest);
+		state = mix(state, word);
+	}
+	return mix(state, 0); /* Последнее перемешивание поднимает младшие биты, из которых берется байт управления */
+}
+
+std::uint64_t PersonHash::hash(std::string_view last_name, std::string_view first_name, std::string_view patronymic) noexcept
+{
+	return combine(hash(last_name), hash(first_name), hash(patronymic));
+}
+
+std::uint64_t PersonHash::combine(std::uint64_t last_name, std::uint64_t first_name, std::uint64_t patronymic) noexcept
+{
+	return mix(mix(last_name, first_name), patronymic);
+}
+
+
+SwissIndex::SwissIndex(std::size_t keys)
+{
+	std::size_t groups = 1;
+	while (groups * group_size * 7 / 8 < keys + 1) /* Хотя бы один пустой слот, иначе поиск промаха не остановится */
+		groups *= 2;
+	allocate(groups);
+}
+
+std::size_t SwissIndex::size() const noexcept
+{
+	return count;
+}
+
+std::int8_t SwissIndex::tag(std::uint64_t hash) noexcept
+{
+	return static_cast<std::int8_t>(hash & 0x7F);
+}
+
+unsigned SwissIndex::matchTag(std::size_t group, std::int8_t value) const noexcept
+{
+	const std::int8_t* first = control.data() + group * group_size;
+#ifdef STACK_SIMD_SCAN
+	__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+	return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+#else
+	unsigned mask = 0;
+	for (std::size_t i = 0; i < group_size; ++i)
+		if (first[i] == value)
+			mask |= 1u << i;
+	return mask;
+#endif
+}
+
+template<typename Equal, typename Rehash>
+SwissIndex::row_type SwissIndex::insert(std::uint64_t hash, row_type value, Equal equal, Rehash rehash)
+{
+	std::size_t slot = 0;
+	row_type found;
+	if (!slots.empty() && locate(hash, equal, found, slot))
+		return found;
+
+	if ((count + 2) * 8 > slots.size() * 7)
+	{
+		grow(rehash);
+		place(hash, value);
+		return value;
+	}
+	control[slot] = tag(hash);
+	slots[slot] = value;
+	++count;
+	return value;
+}
+
+template<typename Equal>
+bool SwissIndex::find(std::uint64_t hash, Equal equal, row_type& value) const
+{
+	std::size_t slot;
+	return !slots.empty() && locate(hash, equal, value, slot);
+}
+
+template<typename Equal>
+bool SwissIndex::locate(std::uint64_t hash, Equal equal, row_type& value, std::size_t& free_slot) const
+{
+	/* Группы перебираются треугольными шагами: при числе групп степени двойки обходятся все */
+	const std::int8_t value_tag = tag(hash);
+	std::size_t group = (hash >> 7) & group_mask;
+	for (std::size_t step = 1; ; ++step)
+	{
+		for (unsigned mask = matchTag(group, value_tag); mask; mask &= mask - 1)
+		{
+			row_type candidate = slots[group * group_size + countTrailingZeros(mask)];
+			if (equal(candidate)) /* Совпали только 7 бит хеша, ключ сверяем */
+			{
+				value = candidate;
+				return true;
+			}
+		}
+		if (unsigned free = matchTag(group, empty)) /* Вставка не идет дальше первой группы со свободным слотом */
+		{
+			free_slot = group * group_size + countTrailingZeros(free);
+			return false;
+		}
+		group = (group + step) & group_mask;
+	}
+}
+
+void SwissIndex::place(std::uint64_t hash, row_type value)
+{
+	std::size_t group = (hash >> 7) & group_mask;
+	for (std::size_t step = 1; ; ++step)
+	{
+		if (unsigned free = matchTag(group, empty))
+		{
+			std::size_t slot = group * group_size + countTrailingZeros(free);
+			control[slot] = tag(hash);
+			slots[slot] = value;
+			++count;
+			return;
+		}
+		group = (group + step) & group_mask;
+	}
+}
+
+template<typename Rehash>
+void SwissIndex::grow(Rehash rehash)
+{
+	/* Новая таблица собирается рядом, старая остается целой, если выделение бросит */
+	SwissIndex bigger;
+	bigger.allocate(slots.empty() ? 1 : slots.size() / group_size * 2);
+	for (std::size_t slot = 0; slot < slots.size(); ++slot)
+		if (control[slot] != empty)
+			bigger.place(rehash(slots[slot]), slots[slot]);
+	*this = std::move(bigger);
+}
+
+void SwissIndex::allocate(std::size_t groups)
+{
+	control.assign(groups * group_size, empty);
+	slots.assign(groups * group_size, 0);
+	group_mask = groups - 1;
+	count = 0;
+}
+
+
+template<typename Container>
+template<typename Check>
+PersonIndex<Container>::PersonIndex(const stack<Person, Container, Check>& stack)
+{
+	if (stack.size() > UINT32_MAX)
+		throw std::length_error("Too many persons to index\n");
+
+	persons.reserve(stack.size());
+	std::vector<row_type> key_of_row[4];
+	for (auto& keys_of_index : key_of_row)
+		keys_of_index.reserve(stack.size());
+
+	/* При построении ключи сверяются без обращения к Person: значения ключей полей лежат подряд в key_bytes,
+	*  а полное имя равно, только если равны номера ключей всех трех полей */
+	std::vector<std::uint64_t> key_hashes[4]; /* Хеш каждого ключа, нужен при росте таблиц */
+	std::string key_bytes[3];
+	std::vector<std::size_t> key_offsets[3] = { { 0 }, { 0 }, { 0 } }; /* Значение ключа key - key_bytes[key_offsets[key], key_offsets[key + 1]) */
+	std::vector<std::array<row_type, 3>> names; /* Номера ключей полей у каждого ключа полного имени */
+
+	for (const Person& person : stack.getContainer())
+	{
+		persons.push_back(&person);
+
+		std::uint64_t hashes[3];
+		std::array<row_type, 3> name;
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			const std::string_view value = field(person, static_cast<Field>(i));
+			const std::string& bytes = key_bytes[i];
+			const std::vector<std::size_t>& offsets = key_offsets[i];
+			const std::vector<std::uint64_t>& known = key_hashes[i];
+			const row_type next = static_cast<row_type>(known.size());
+			hashes[i] = PersonHash::hash(value);
+			name[i] = keys[i].index.insert(hashes[i], next,
+				[&](row_type key) { return std::string_view(bytes.data() + offsets[key], offsets[key + 1] - offsets[key]) == value; },
+				[&](row_type key) { return known[key]; });
+			if (name[i] == next)
+			{
+				key_hashes[i].push_back(hashes[i]);
+				key_bytes[i].append(value);
+				key_offsets[i].push_back(key_bytes[i].size());
+			}
+			key_of_row[i].push_back(name[i]);
+		}
+
+		const std::uint64_t hash = PersonHash::combine(hashes[0], hashes[1], hashes[2]);
+		const row_type next = static_cast<row_type>(names.size());
+		const row_type key = keys[3].index.insert(hash, next, [&](row_type key) { return names[key] == name; },
+			[&](row_type key) { return key_hashes[3][key]; });
+		if (key == next)
+		{
+			key_hashes[3].push_back(hash);
+			names.push_back(name);
+		}
+		key_of_row[3].push_back(key);
+	}
+
+	for (std::size_t i = 0; i < 4; ++i)
+		group(keys[i], key_of_row[i], key_hashes[i].size());
+}
+
+template<typename Container>
+std::size_t PersonIndex<Container>::size() const noexcept
+{
+	return persons.size();
+}
+
+template<typename Container>
+std::vector<const Person*> PersonIndex<Container>::find(Field field, std::string_view value) const
+{
+	return collect(keys[static_cast<std::size_t>(field)], PersonHash::hash(value),
+		[&](const Person& person) { return PersonIndex::field(person, field) == value; });
+}
+
+template<typename Container>
+std::vector<const Person*> PersonIndex<Container>::find(std::string_view last_name, std::string_view first_name,
+	std::string_view patronymic) const
+{
+	return collect(keys[3], PersonHash::hash(last_name, first_name, patronymic), [&](const Person& person)
+		{
+			return person.getLastName() == last_name && person.getFirstName() == first_name && person.getPatronymic() == patronymic;
+		});
+}
+
+template<typename Container>
+void PersonIndex<Container>::group(Keys& keys, const std::vector<row_type>& key_of_row, std::size_t distinct)
+{
+	/* Сортировка подсчетом: строки каждого ключа ложатся подряд в порядке контейнера */
+	keys.offsets.assign(distinct + 1, 0);
+	for (row_type key : key_of_row)
+		++keys.offsets[key + 1];
+	for (std::size_t key = 1; key < keys.offsets.size(); ++key)
+		keys.offsets[key] += keys.offsets[key - 1];
+
+	std::vector<row_type> cursor(keys.offsets.begin(), keys.offsets.end() - 1);
+	keys.rows.resize(key_of_row.size());
+	for (std::size_t row = 0; row < key_of_row.size(); ++row)
+		keys.rows[cursor[key_of_row[row]]++] = static_cast<row_type>(row);
+}
+
+template<typename Container>
+template<typename Equal>
+std::vector<const Person*> PersonIndex<Container>::collect(const Keys& keys, std::uint64_t hash, Equal equal) const
+{
+	std::vector<const Person*> result;
+	row_type key;
+	if (!keys.index.find(hash, [&](row_type candidate) { return equal(*persons[keys.rows[keys.offsets[candidate]]]); }, key))
+		return result;
+
+	result.reserve(keys.offsets[key + 1] - keys.offsets[key]);
+	for (row_type i = keys.offsets[key]; i < keys.offsets[key + 1]; ++i)
+		result.push_back(persons[keys.rows[i]]);
+	return result;
+}
+
+template<typename Container>
+std::string_view PersonIndex<Container>::field(const Person& person, Field field) noexcept
+{
+	switch (field)
+	{
+	case Field::LastName:
+		return person.getLastName();
+	case Field::FirstName:
+		return person.getFirstName();
+	default:
+		return person.getPatronymic();
+	}
+}
+
+
+#endif
\ No newline at end of file
@@ -3,24 +3,96 @@
 
 
 #include <string>
+#include <string_view>
 #include <fstream>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 
 #include "stack.hpp"
 #include "Person.hpp"
+#include "MappedFile.hpp"
+#include "ByteScan.hpp"
+#include "NamePool.hpp"
+#include "PersonView.hpp"
+#include "PersonTable.hpp"
+#include "list.hpp"
+
+
+class PersonReader;
 
 
 class PersonKeeper final
 {
+	friend class PersonReader; /* Потоковое чтение использует тот же разбор строк */
 public:
 
 	using container = stack<Person>;
+	using view_container = stack<PersonView, list<PersonView, std::pmr::polymorphic_allocator<PersonView>>>;
 
 	static PersonKeeper& instance();
 	stack<Person> readPersons(std::fstream& fstream) const; /* Записываем из файла в стек и возвращаем стек */
+	stack<Person> readPersons(const std::string& file_name) const; /* То же, но файл отображается в память и разбирается без копирования строк */
+	stack<Person> readPersons(const std::string& file_name, std::size_t threads) const; /* То же, но файл разбирается параллельно на threads потоках (0 - по числу ядер) */
 	void writePersons(const container& stack, std::fstream& fstream) const; /* Записываем входящего из стека в файл */
+	void writePersons(const container& stack, const std::string& file_name) const; /* То же, но блоки уходят в файл через write, минуя fstream */
+
+	/* Бинарный формат: заголовок, таблица длин полей (по три uint32 на запись) и один общий блок байтов имен */
+	stack<Person> readPersonsBinary(const std::string& file_name) const; /* Читаем стек из бинарного файла */
+	void writePersonsBinary(const container& stack, const std::string& file_name) const; /* Записываем стек в бинарный файл */
+	void convertTextToBinary(const std::string& text_file, const std::string& binary_file) const; /* Переводит текстовый файл в бинарный */
+	void convertBinaryToText(const std::string& binary_file, const std::string& text_file) const; /* Переводит бинарный файл в текстовый */
+
+	/* Чтение в арену: байты имен копируются одним блоком, узлы списка тоже берутся из arena.
+	*  Все освобождается разом вместе с arena (например, std::pmr::monotonic_buffer_resource),
+	*  поэтому стек не должен ее пережить. */
+	view_container readPersonViews(const std::string& file_name, std::pmr::memory_resource& arena) const;
+
+	/* Чтение сразу в колоночную таблицу, поля копируются из отображения прямо в колонки */
+	PersonTable readTable(const std::string& file_name) const;
+
+	/* Чтение с интернированием имен: одинаковые имена хранятся в pool один раз, запись - три id */
+	stack<InternedPerson> readPersonsInterned(const std::string& file_name, NamePool& pool) const;
+
+	/* Потоковое чтение: записи отдаются по одной в callback(Person&&), в памяти держится только буфер чтения */
+	template<typename Callback>
+	std::size_t forEachPerson(std::fstream& fstream, Callback callback) const; /* Возвращает число прочитанных записей */
 private:
 
+	static Person parseLine(const char* first, const char* last); /* Разбирает строку "фамилия имя отчество" без перевода строки */
+	static Person parseRecord(const char*& it, const char* end); /* Разбирает строку буфера с позиции it и сдвигает it за ее конец */
+	static void splitRecord(const char*& it, const char* end, /* То же, но поля отдаются как string_view внутрь буфера */
+		std::string_view& last_name, std::string_view& first_name, std::string_view& patronymic) noexcept;
+	template<typename Sink>
+	static void formatPersons(const container& stack, Sink sink); /* Форматирует записи блоками по write_block_size и отдает их в sink(data, size) */
+
+	static constexpr std::size_t min_chunk_size = 1 << 16; /* Меньшие куски не окупают запуск потока */
+	static constexpr std::size_t write_block_size = 1 << 20; /* Размер блока, которым буфер сбрасывается в поток */
+
+	/* Заголовок бинарного файла, числа хранятся в порядке байт машины (little-endian на x86/ARM) */
+	struct BinaryHeader final
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint64_t count; /* Количество записей */
+		std::uint64_t blob_size; /* Размер блока имен в байтах */
+	};
+
+	static constexpr char binary_magic[4] = { 'P', 'K', 'B', 'N' };
+	static constexpr std::uint32_t binary_version = 1;
+
 	PersonKeeper() = default;
 	~PersonKeeper() = default;
 
@@ -31,6 +103,36 @@ private:
 };
 
 
+/*
+*  Потоковый читатель текстового файла с людьми.
+*  Читает поток блоками в буфер фиксированного размера и разбирает записи прямо в нем,
+*  поэтому память не растет с размером файла. Буфер увеличивается только если
+*  одна строка в него не помещается. Строки разбираются так же, как в readPersons(std::fstream&).
+*/
+class PersonReader final
+{
+public:
+	/* Конструкторы и деструктор */
+	explicit PersonReader(std::istream& stream, std::size_t buffer_size = 1 << 16);
+	~PersonReader() = default;
+
+	PersonReader(const PersonReader& oth) = delete;
+	PersonReader& operator=(const PersonReader& oth) = delete;
+	/* Методы */
+	bool next(Person& person); /* Читает следующую запись; false, если записи кончились */
+	std::size_t nextBatch(std::vector<Person>& batch, std::size_t max_count); /* Заменяет содержимое batch следующими max_count записями */
+private:
+
+	void refill(); /* Сдвигает недочитанный хвост в начало буфера и дочитывает поток */
+
+	std::istream& stream;
+	std::vector<char> buffer;
+	std::size_t begin = 0; /* Начало неразобранных данных */
+	std::size_t end = 0; /* Конец прочитанных данных */
+	bool exhausted = false; /* Поток дочитан до конца */
+};
+
+
 PersonKeeper& PersonKeeper::instance()
 {
 	static PersonKeeper keeper;
@@ -45,48 +147,459 @@ stack<Person> PersonKeeper::readPersons(std::fstream& fstream) const
 	stack<Person> stack;
 	std::string buffer;
 	while (std::getline(fstream, buffer)) /* Записываем строки в буфер */
+		stack.push(parseLine(buffer.data(), buffer.data() + buffer.size())); /* Пушим в стек */
+
+	return stack;
+}
+
+stack<Person> PersonKeeper::readPersons(const std::string& file_name) const
+{
+	MappedFile file(file_name);
+
+	stack<Person> stack;
+	const char* it = file.data();
+	const char* end = it + file.size();
+	while (it != end) /* Идем по строкам прямо в отображенной памяти */
+		stack.push(parseRecord(it, end));
+
+	return stack;
+}
+
+stack<Person> PersonKeeper::readPersons(const std::string& file_name, std::size_t threads) const
+{
+	MappedFile file(file_name);
+
+	if (threads == 0)
+		threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+	threads = std::max<std::size_t>(std::min(threads, file.size() / min_chunk_size), 1);
+	if (threads == 1) /* Один кусок - разбираем сразу в стек, без промежуточного вектора и переноса */
+	{
+		stack<Person> stack;
+		const char* end = file.data() + file.size();
+		for (const char* it = file.data(); it != end;)
+			stack.push(parseRecord(it, end));
+		return stack;
+	}
+
+	/* Режем файл на куски примерно равного размера, границы сдвигаем за ближайший перевод строки */
+	const char* begin = file.data();
+	const char* end = begin + file.size();
+	std::vector<const char*> bounds{ begin };
+	for (std::size_t i = 1; i < threads; ++i)
 	{
-		auto it = buffer.cbegin();
+		const char* bound = std::max(begin + file.size() / threads * i, bounds.back());
+		bound = findByte(bound, end, '\n');
+		bounds.push_back(bound == end ? end : bound + 1);
+	}
+	bounds.push_back(end);
 
-		std::string last_name; /* Идем до пробела, и записываем во временную "фамилию" */
-		for (; it != buffer.cend(); ++it)
+	/* Каждый кусок разбирается в свой вектор, исключение потока сохраняем и пробрасываем после join */
+	std::vector<std::vector<Person>> chunks(threads);
+	std::vector<std::exception_ptr> errors(threads);
+	auto parse_chunk = [&](std::size_t index)
+	{
+		try
 		{
-			if (*it == ' ')
-			{
-				++it;
-				break;
-			}
-			last_name.push_back(*it);
+			for (const char* it = bounds[index]; it != bounds[index + 1];)
+				chunks[index].push_back(parseRecord(it, bounds[index + 1]));
+		}
+		catch (...)
+		{
+			errors[index] = std::current_exception();
 		}
+	};
 
-		std::string first_name;
-		for (; it != buffer.cend(); ++it) /* Идем до след. пробела, и записываем во временное "имя" */
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	try
+	{
+		for (std::size_t i = 1; i < threads; ++i)
+			workers.emplace_back(parse_chunk, i);
+	}
+	catch (...)
+	{ /* Не смогли запустить поток - дожидаемся запущенных, иначе их деструктор вызовет terminate */
+		for (auto& worker : workers)
+			worker.join();
+		throw;
+	}
+	parse_chunk(0); /* Первый кусок разбираем в текущем потоке */
+	for (auto& worker : workers)
+		worker.join();
+
+	for (auto& error : errors)
+		if (error)
+			std::rethrow_exception(error);
+
+	/* Склеиваем куски в порядке файла, как при последовательном чтении */
+	stack<Person> stack;
+	for (auto& chunk : chunks)
+		for (auto& person : chunk)
+			stack.push(std::move(person));
+
+	return stack;
+}
+
+void PersonKeeper::writePersons(const container& stack, std::fstream& fstream) const
+{
+	if (!fstream.is_open())
+		throw std::runtime_error("File not found\n");
+
+	formatPersons(stack, [&fstream](const char* data, std::size_t size)
 		{
-			if (*it == ' ')
+			fstream.write(data, static_cast<std::streamsize>(size));
+		});
+}
+
+void PersonKeeper::writePersons(const container& stack, const std::string& file_name) const
+{
+#ifdef _WIN32
+	/* Прямой записи в дескриптор нет - используем fstream */
+	std::fstream fstream(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+	writePersons(stack, fstream);
+#else
+	int fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		throw std::runtime_error("File not found\n");
+
+	/* Блок отдаем ядру напрямую, дописывая его при частичной записи */
+	try
+	{
+		formatPersons(stack, [fd](const char* data, std::size_t size)
 			{
-				++it;
-				break;
-			}
-			first_name.push_back(*it);
+				while (size > 0)
+				{
+					ssize_t written = ::write(fd, data, size);
+					if (written < 0)
+					{
+						if (errno == EINTR)
+							continue;
+						throw std::runtime_error("Cannot write file\n");
+					}
+					data += written;
+					size -= static_cast<std::size_t>(written);
+				}
+			});
+	}
+	catch (...)
+	{ /* Ошибка записи или нехватка памяти под буфер - дескриптор закрываем в любом случае */
+		::close(fd);
+		throw;
+	}
+
+	if (::close(fd) != 0)
+		throw std::runtime_error("Cannot write file\n");
+#endif
+}
+
+template<typename Sink>
+void PersonKeeper::formatPersons(const container& stack, Sink sink)
+{
+	/* Форматируем записи в один буфер без временных строк и сбрасываем его большими блоками */
+	std::string buffer;
+	buffer.reserve(write_block_size);
+	for (const Person& person : stack.getContainer())
+	{
+		buffer.append(person.getLastName()).append(1, ' ');
+		buffer.append(person.getFirstName()).append(1, ' ');
+		buffer.append(person.getPatronymic()).append(1, '\n');
+		if (buffer.size() >= write_block_size)
+		{
+			sink(buffer.data(), buffer.size());
+			buffer.clear();
 		}
+	}
+	if (!buffer.empty())
+		sink(buffer.data(), buffer.size());
+}
+
+stack<Person> PersonKeeper::readPersonsBinary(const std::string& file_name) const
+{
+	MappedFile file(file_name);
+
+	BinaryHeader header;
+	if (file.size() < sizeof(header))
+		throw std::runtime_error("Invalid binary person file\n");
+	std::memcpy(&header, file.data(), sizeof(header));
 
-		std::string patronymic; /* Остаток записываем в "отчество" */
-		for (; it != buffer.cend(); ++it)
-			patronymic.push_back(*it);
+	/* Проверяем заголовок и то, что таблица длин и блок имен целиком лежат в файле */
+	const std::uint64_t payload = file.size() - sizeof(header);
+	if (std::memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0 || header.version != binary_version
+		|| header.count > payload / (3 * sizeof(std::uint32_t))
+		|| header.blob_size != payload - header.count * 3 * sizeof(std::uint32_t))
+		throw std::runtime_error("Invalid binary person file\n");
 
-		stack.push(Person(std::move(last_name), std::move(first_name), std::move(patronymic)));/* Пушим в стек */
+	const char* lengths = file.data() + sizeof(header);
+	const char* blob = lengths + header.count * 3 * sizeof(std::uint32_t);
+	const char* blob_end = blob + header.blob_size;
+
+	stack<Person> stack;
+	auto next_field = [&](std::size_t index)
+	{
+		std::uint32_t length;
+		std::memcpy(&length, lengths + index * sizeof(length), sizeof(length));
+		if (length > static_cast<std::size_t>(blob_end - blob))
+			throw std::runtime_error("Invalid binary person file\n");
+
+		std::string field(blob, length); /* Строка сразу нужного размера */
+		blob += length;
+		return field;
+	};
+
+	for (std::uint64_t i = 0; i < header.count; ++i)
+	{
+		std::string last_name = next_field(i * 3);
+		std::string first_name = next_field(i * 3 + 1);
+		std::string patronymic = next_field(i * 3 + 2);
+		stack.push(Person(std::move(last_name), std::move(first_name), std::move(patronymic)));
 	}
 
 	return stack;
 }
 
-void PersonKeeper::writePersons(const container& stack, std::fstream& fstream) const
+void PersonKeeper::writePersonsBinary(const container& stack, const std::string& file_name) const
 {
+	std::fstream fstream(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
 	if (!fstream.is_open())
 		throw std::runtime_error("File not found\n");
 
-	for (auto it : stack.getContainer()) /* Записываем в стек из контейнера */
-		fstream << it.getLastName() + ' ' + it.getFirstName() + ' ' + it.getPatronymic() + '\n';
+	BinaryHeader header;
+	std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+	header.version = binary_version;
+	header.count = stack.size();
+	header.blob_size = 0;
+
+	/* Сначала таблица длин, по ней же считаем размер блока имен */
+	std::vector<std::uint32_t> lengths;
+	lengths.reserve(stack.size() * 3);
+	for (const Person& person : stack.getContainer())
+		for (const std::string* field : { &person.getLastName(), &person.getFirstName(), &person.getPatronymic() })
+		{
+			if (field->size() > std::numeric_limits<std::uint32_t>::max())
+				throw std::runtime_error("Name is too long for binary person file\n");
+			lengths.push_back(static_cast<std::uint32_t>(field->size()));
+			header.blob_size += field->size();
+		}
+
+	fstream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	fstream.write(reinterpret_cast<const char*>(lengths.data()), static_cast<std::streamsize>(lengths.size() * sizeof(std::uint32_t)));
+
+	std::string buffer; /* Блок имен пишем через буфер, как и в текстовом формате */
+	buffer.reserve(write_block_size);
+	for (const Person& person : stack.getContainer())
+	{
+		buffer.append(person.getLastName()).append(person.getFirstName()).append(person.getPatronymic());
+		if (buffer.size() >= write_block_size)
+		{
+			fstream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+		}
+	}
+	fstream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+	if (!fstream)
+		throw std::runtime_error("Cannot write file\n");
+}
+
+void PersonKeeper::convertTextToBinary(const std::string& text_file, const std::string& binary_file) const
+{
+	writePersonsBinary(readPersons(text_file), binary_file);
+}
+
+void PersonKeeper::convertBinaryToText(const std::string& binary_file, const std::string& text_file) const
+{
+	writePersons(readPersonsBinary(binary_file), text_file);
+}
+
+PersonKeeper::view_container PersonKeeper::readPersonViews(const std::string& file_name, std::pmr::memory_resource& arena) const
+{
+	MappedFile file(file_name);
+
+	/* Копируем весь файл в арену одной аллокацией, представления будут указывать в эту копию */
+	char* begin = static_cast<char*>(arena.allocate(std::max<std::size_t>(file.size(), 1), 1));
+	if (file.size())
+		std::memcpy(begin, file.data(), file.size());
+
+	std::pmr::polymorphic_allocator<PersonView> alloc(&arena);
+	view_container stack(list<PersonView, std::pmr::polymorphic_allocator<PersonView>>{ alloc });
+	const char* it = begin;
+	const char* end = begin + file.size();
+	std::string_view last_name, first_name, patronymic;
+	while (it != end)
+	{
+		splitRecord(it, end, last_name, first_name, patronymic);
+		stack.emplace(last_name, first_name, patronymic);
+	}
+
+	return stack;
+}
+
+PersonTable PersonKeeper::readTable(const std::string& file_name) const
+{
+	MappedFile file(file_name);
+
+	PersonTable table;
+	const char* it = file.data();
+	const char* end = it + file.size();
+	std::string_view last_name, first_name, patronymic;
+	while (it != end)
+	{
+		splitRecord(it, end, last_name, first_name, patronymic);
+		table.push_back(last_name, first_name, patronymic);
+	}
+
+	return table;
+}
+
+stack<InternedPerson> PersonKeeper::readPersonsInterned(const std::string& file_name, NamePool& pool) const
+{
+	MappedFile file(file_name);
+
+	stack<InternedPerson> stack;
+	const char* it = file.data();
+	const char* end = it + file.size();
+	std::string_view last_name, first_name, patronymic;
+	while (it != end) /* Поля берем как string_view в отображение и сразу интернируем, без промежуточных строк */
+	{
+		splitRecord(it, end, last_name, first_name, patronymic);
+		stack.emplace(pool.intern(last_name), pool.intern(first_name), pool.intern(patronymic));
+	}
+
+	return stack;
+}
+
+template<typename Callback>
+std::size_t PersonKeeper::forEachPerson(std::fstream& fstream, Callback callback) const
+{
+	if (!fstream.is_open()) /* Проверяем, открыли или нет */
+		throw std::runtime_error("File not found\n");
+
+	PersonReader reader(fstream);
+	Person person;
+	std::size_t count = 0;
+	for (; reader.next(person); ++count)
+		callback(std::move(person));
+
+	return count;
+}
+
+Person PersonKeeper::parseLine(const char* first, const char* last)
+{
+	const char* space = findByte(first, last, ' '); /* Идем до пробела - это "фамилия" */
+	std::string last_name(first, space);
+	first = space == last ? last : space + 1;
+
+	space = findByte(first, last, ' '); /* Идем до след. пробела - это "имя" */
+	std::string first_name(first, space);
+	first = space == last ? last : space + 1;
+
+	std::string patronymic(first, last); /* Остаток записываем в "отчество" */
+
+	/* Строки создаются сразу нужного размера, без посимвольного push_back */
+	return Person(std::move(last_name), std::move(first_name), std::move(patronymic));
+}
+
+Person PersonKeeper::parseRecord(const char*& it, const char* end)
+{
+	std::string_view last_name, first_name, patronymic;
+	splitRecord(it, end, last_name, first_name, patronymic);
+
+	/* Строки создаются сразу нужного размера */
+	return Person(std::string(last_name), std::string(first_name), std::string(patronymic));
+}
+
+void PersonKeeper::splitRecord(const char*& it, const char* end,
+	std::string_view& last_name, std::string_view& first_name, std::string_view& patronymic) noexcept
+{
+	/* Поле от token до delimiter; '\r' перед переводом строки остается в поле, как у std::getline и PersonReader */
+	auto field = [](const char* token, const char* delimiter)
+	{
+		return std::string_view(token, static_cast<std::size_t>(delimiter - token));
+	};
+
+	/* Ищем пробел и перевод строки за один проход, чтобы не сканировать строку дважды */
+	const char* token = it;
+	const char* delimiter = findEither(token, end, ' ', '\n');
+	last_name = field(token, delimiter);
+	first_name = std::string_view();
+	patronymic = std::string_view();
+
+	if (delimiter != end && *delimiter == ' ')
+	{
+		token = delimiter + 1;
+		delimiter = findEither(token, end, ' ', '\n');
+		first_name = field(token, delimiter);
+
+		if (delimiter != end && *delimiter == ' ') /* Остаток строки вместе с лишними пробелами - "отчество" */
+		{
+			token = delimiter + 1;
+			delimiter = findByte(token, end, '\n');
+			patronymic = field(token, delimiter);
+		}
+	}
+
+	it = delimiter == end ? end : delimiter + 1;
+}
+
+
+PersonReader::PersonReader(std::istream& stream, std::size_t buffer_size)
+	: stream(stream),
+	buffer(std::max<std::size_t>(buffer_size, 1))
+{}
+
+bool PersonReader::next(Person& person)
+{
+	for (;;)
+	{
+		const char* first = buffer.data() + begin;
+		const char* last = buffer.data() + end;
+		const char* newline = findByte(first, last, '\n');
+		if (newline != last) /* Строка целиком в буфере */
+		{
+			person = PersonKeeper::parseLine(first, newline);
+			begin = static_cast<std::size_t>(newline - buffer.data()) + 1;
+			return true;
+		}
+
+		if (exhausted) /* Последняя строка без перевода строки, как у std::getline */
+		{
+			if (begin == end)
+				return false;
+
+			person = PersonKeeper::parseLine(first, last);
+			begin = end;
+			return true;
+		}
+
+		refill();
+	}
+}
+
+std::size_t PersonReader::nextBatch(std::vector<Person>& batch, std::size_t max_count)
+{
+	batch.resize(max_count);
+	std::size_t count = 0;
+	while (count < max_count && next(batch[count]))
+		++count;
+
+	batch.resize(count);
+	return count;
+}
+
+void PersonReader::refill()
+{
+	std::size_t tail = end - begin;
+	if (begin != 0)
+		std::memmove(buffer.data(), buffer.data() + begin, tail);
+	begin = 0;
+	end = tail;
+
+	if (end == buffer.size()) /* Строка не влезла в буфер - увеличиваем его */
+		buffer.resize(buffer.size() * 2);
+
+	stream.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+	end += static_cast<std::size_t>(stream.gcount());
+	if (!stream)
+		exhausted = true;
 }
 
 
@@ -0,0 +1,164 @@
+﻿#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "PersonKeeper.hpp"
+
+/*
+*  Проверка бинарного формата: writePersonsBinary -> readPersonsBinary возвращает те же записи
+*  (пустой стек, пустые поля, длинные имена больше блока записи, кириллица, пробелы и '\n' внутри полей).
+*  Испорченные файлы - каждое усечение, чужая сигнатура и версия, счетчики и длины, выходящие за файл, -
+*  должны отвергаться runtime_error без чтения за пределами файла (под ASan).
+*  Раскладка заголовка: сигнатура [0, 4), версия [4, 8), число записей [8, 16), размер блока имен [16, 24),
+*  затем по три uint32 длины на запись.
+*      g++ -std=c++17 -g -fsanitize=address,undefined PersonKeeper_test.cpp -o PersonKeeper_test
+*/
+
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+	if (!condition)
+	{
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+}
+
+static const std::string file_name = "PersonKeeper_test.bin";
+
+static std::string readFile()
+{
+	std::ifstream file(file_name, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::string& bytes)
+{
+	std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+	file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+static std::vector<std::string> fields(const stack<Person>& persons)
+{
+	std::vector<std::string> result;
+	for (const Person& person : persons.getContainer())
+	{
+		result.push_back(person.getLastName());
+		result.push_back(person.getFirstName());
+		result.push_back(person.getPatronymic());
+	}
+	return result;
+}
+
+/* true, если readPersonsBinary отверг файл с такими байтами */
+static bool rejects(const std::string& bytes)
+{
+	writeFile(bytes);
+	try
+	{
+		PersonKeeper::instance().readPersonsBinary(file_name);
+	}
+	catch (const std::runtime_error&)
+	{
+		return true;
+	}
+	return false;
+}
+
+template<typename Value>
+static std::string patched(std::string bytes, std::size_t offset, Value value)
+{
+	std::memcpy(&bytes[offset], &value, sizeof(value));
+	return bytes;
+}
+
+static void testRoundTrip(const stack<Person>& persons, const char* what)
+{
+	PersonKeeper::instance().writePersonsBinary(persons, file_name);
+	const stack<Person> loaded = PersonKeeper::instance().readPersonsBinary(file_name);
+	check(loaded.size() == persons.size() && fields(loaded) == fields(persons), what);
+}
+
+static stack<Person> samplePersons()
+{
+	stack<Person> persons;
+	persons.push(Person("Иванов", "Иван", "Иванович"));
+	persons.push(Person("", "", ""));
+	persons.push(Person("Smith", "", "Jr"));
+	persons.push(Person(std::string("с пробелом\nи переводом строки"), "\t", std::string("\0нуль", 9)));
+	std::string long_cyrillic;
+	for (int i = 0; i < 35000; ++i)
+		long_cyrillic += "я";
+	persons.push(Person(std::string((1 << 20) + 17, 'a'), long_cyrillic, "x")); /* Длиннее блока записи */
+	return persons;
+}
+
+static void testRoundTrips()
+{
+	testRoundTrip(stack<Person>(), "empty stack round-trips");
+	testRoundTrip(samplePersons(), "empty, long and non-ASCII fields round-trip");
+
+	stack<Person> many;
+	for (int i = 0; i < 5000; ++i)
+		many.push(Person("Фамилия" + std::to_string(i), std::string(static_cast<std::size_t>(i % 7), 'b'), "Отчество"));
+	testRoundTrip(many, "many records round-trip in order");
+}
+
+static void testCorruption()
+{
+	stack<Person> persons;
+	persons.push(Person("Иванов", "Иван", "Иванович"));
+	persons.push(Person("Петров", "", "Петрович"));
+	PersonKeeper::instance().writePersonsBinary(persons, file_name);
+	const std::string valid = readFile();
+	const std::size_t header_size = 24;
+	check(valid.size() > header_size + 6 * sizeof(std::uint32_t) && !rejects(valid), "valid file is accepted");
+
+	/* Любое усечение: заголовка, таблицы длин или блока имен */
+	bool all_truncations = true;
+	for (std::size_t size = 0; size < valid.size(); ++size)
+		all_truncations = all_truncations && rejects(valid.substr(0, size));
+	check(all_truncations, "every truncated file is rejected");
+	check(rejects(valid + 'x'), "trailing garbage is rejected");
+
+	check(rejects(patched(valid, 0, 'X')), "wrong magic is rejected");
+	check(rejects(patched(valid, 4, std::uint32_t(2))), "unknown version is rejected");
+
+	const std::uint64_t counts[] = { 3, 1, 0, std::uint64_t(1) << 62, ~std::uint64_t(0) / 12 + 1, ~std::uint64_t(0) };
+	for (std::uint64_t count : counts)
+		check(rejects(patched(valid, 8, count)), "count inconsistent with the file is rejected: " + std::to_string(count));
+
+	std::uint64_t blob_size;
+	std::memcpy(&blob_size, valid.data() + 16, sizeof(blob_size));
+	const std::uint64_t blob_sizes[] = { 0, blob_size - 1, blob_size + 1, ~std::uint64_t(0) };
+	for (std::uint64_t size : blob_sizes)
+		check(rejects(patched(valid, 16, size)), "blob size inconsistent with the file is rejected: " + std::to_string(size));
+
+	/* Заголовок согласован, но длины полей не помещаются в блок имен */
+	check(rejects(patched(valid, header_size, ~std::uint32_t(0))), "field length past the blob is rejected");
+	check(rejects(patched(valid, header_size + 5 * sizeof(std::uint32_t), std::uint32_t(blob_size))), "last field running past the blob is rejected");
+	check(rejects(patched(patched(valid, header_size, std::uint32_t(blob_size)), header_size + 4, std::uint32_t(1))),
+		"fields adding up past the blob are rejected");
+}
+
+
+int main()
+{
+	testRoundTrips();
+	testCorruption();
+	std::remove(file_name.c_str());
+
+	if (failures)
+		return 1;
+	std::cout << "PersonKeeper_test: OK\n";
+	return 0;
+}
@@ -0,0 +1,221 @@
+﻿#ifndef _PersonSort_hpp
+#define _PersonSort_hpp
+
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "stack.hpp"
+#include "Person.hpp"
+#include "PersonTable.hpp"
+
+/*
+*  Параллельная сортировка людей по (фамилия, имя, отчество) с удалением повторов.
+*  Схема - слиянием: массив режется на куски по числу потоков, каждый кусок сортируется std::sort
+*  в своем потоке, затем куски сливаются попарно раундами, пары одного раунда - параллельно.
+*  Во всех функциях threads == 0 означает число ядер.
+*/
+
+
+/* Порядок (фамилия, имя, отчество) */
+struct PersonLess final
+{
+	bool operator()(const Person& left, const Person& right) const noexcept;
+};
+
+template<typename Task>
+void runParallel(std::size_t tasks, Task task); /* Выполняет task(i) для i из [0, tasks), по потоку на задачу */
+
+template<typename Type, typename Less>
+void parallelSort(std::vector<Type>& values, Less less, std::size_t threads = 0); /* Сортирует values на threads потоках */
+
+template<typename Container, typename Check>
+void sortUnique(stack<Person, Container, Check>& stack, std::size_t threads = 0); /* Сортирует стек и убирает повторы, наверху - наибольший; при исключении стек не меняется */
+PersonTable sortUnique(const PersonTable& table, std::size_t threads = 0); /* Отсортированная таблица без повторов */
+
+std::size_t sortThreads(std::size_t threads, std::size_t size) noexcept; /* Сколько потоков стоит запускать для size элементов */
+
+/* Есть ли у контейнера get_allocator() */
+template<typename Container, typename = void>
+struct has_get_allocator : std::false_type {};
+template<typename Container>
+struct has_get_allocator<Container, std::void_t<decltype(std::declval<const Container&>().get_allocator())>> : std::true_type {};
+
+template<typename Container>
+Container emptyLike(const Container& container); /* Пустой контейнер с тем же аллокатором, что у container */
+
+
+std::size_t sortThreads(std::size_t threads, std::size_t size) noexcept
+{
+	constexpr std::size_t min_chunk_size = 1 << 14; /* Меньшие куски не окупают запуск потока */
+	if (threads == 0)
+		threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+	return std::max<std::size_t>(std::min(threads, size / min_chunk_size), 1);
+}
+
+bool PersonLess::operator()(const Person& left, const Person& right) const noexcept
+{
+	if (int order = left.getLastName().compare(right.getLastName()))
+		return order < 0;
+	if (int order = left.getFirstName().compare(right.getFirstName()))
+		return order < 0;
+	return left.getPatronymic() < right.getPatronymic();
+}
+
+template<typename Task>
+void runParallel(std::size_t tasks, Task task)
+{
+	/* Исключение задачи сохраняем и пробрасываем после join, как при параллельном чтении */
+	std::vector<std::exception_ptr> errors(tasks);
+	auto run = [&](std::size_t index)
+	{
+		try
+		{
+			task(index);
+		}
+		catch (...)
+		{
+			errors[index] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(tasks > 0 ? tasks - 1 : 0);
+	try
+	{
+		for (std::size_t i = 1; i < tasks; ++i)
+			workers.emplace_back(run, i);
+	}
+	catch (...)
+	{ /* Не смогли запустить поток - дожидаемся запущенных, иначе их деструктор вызовет terminate */
+		for (auto& worker : workers)
+			worker.join();
+		throw;
+	}
+	if (tasks > 0)
+		run(0); /* Первую задачу выполняем в текущем потоке */
+	for (auto& worker : workers)
+		worker.join();
+
+	for (auto& error : errors)
+		if (error)
+			std::rethrow_exception(error);
+}
+
+template<typename Type, typename Less>
+void parallelSort(std::vector<Type>& values, Less less, std::size_t threads)
+{
+	threads = sortThreads(threads, values.size());
+	if (threads == 1)
+	{
+		std::sort(values.begin(), values.end(), less);
+		return;
+	}
+
+	std::vector<std::size_t> bounds;
+	for (std::size_t i = 0; i <= threads; ++i)
+		bounds.push_back(values.size() / threads * i + std::min(i, values.size() % threads));
+
+	runParallel(threads, [&](std::size_t index)
+		{
+			std::sort(values.begin() + bounds[index], values.begin() + bounds[index + 1], less);
+		});
+
+	/* Раунды попарных слияний из values в buffer и обратно, пока не останется один кусок */
+	std::vector<Type> buffer(values.size());
+	std::vector<Type>* from = &values;
+	std::vector<Type>* to = &buffer;
+	while (bounds.size() > 2)
+	{
+		const std::size_t chunks = bounds.size() - 1;
+		runParallel((chunks + 1) / 2, [&](std::size_t pair)
+			{
+				auto source = std::make_move_iterator(from->begin());
+				const std::size_t first = bounds[2 * pair];
+				const std::size_t middle = bounds[std::min(2 * pair + 1, chunks)];
+				const std::size_t last = bounds[std::min(2 * pair + 2, chunks)];
+				std::merge(source + first, source + middle, source + middle, source + last, to->begin() + first, less);
+			});
+
+		std::vector<std::size_t> merged;
+		for (std::size_t i = 0; i < bounds.size(); i += 2)
+			merged.push_back(bounds[i]);
+		if (merged.back() != bounds.back())
+			merged.push_back(bounds.back());
+		bounds.swap(merged);
+		std::swap(from, to);
+	}
+
+	if (from != &values)
+		values.swap(buffer);
+}
+
+template<typename Container>
+Container emptyLike(const Container& container)
+{
+	if constexpr (has_get_allocator<Container>::value)
+		return Container(container.get_allocator());
+	else
+	{ /* Аллокатор наружу не отдается - копируем контейнер целиком и очищаем */
+		Container empty(container);
+		while (!empty.empty())
+			empty.pop_back();
+		return empty;
+	}
+}
+
+template<typename Container, typename Check>
+void sortUnique(stack<Person, Container, Check>& stack, std::size_t threads)
+{
+	/* Сортируем копию и подменяем стек обменом в самом конце: если сортировка, запуск потока
+	*  или выделение памяти бросят исключение, стек остается прежним */
+	std::vector<Person> persons(stack.getContainer().begin(), stack.getContainer().end());
+
+	parallelSort(persons, PersonLess(), threads);
+	auto last = std::unique(persons.begin(), persons.end(), [](const Person& left, const Person& right)
+		{
+			return !PersonLess()(left, right); /* Массив отсортирован, поэтому !(left < right) значит равенство */
+		});
+
+	std::decay_t<decltype(stack)> sorted(emptyLike(stack.getContainer()));
+	for (auto it = persons.begin(); it != last; ++it)
+		sorted.push(std::move(*it));
+	stack.swap(sorted);
+}
+
+PersonTable sortUnique(const PersonTable& table, std::size_t threads)
+{
+	using Field = PersonTable::Field;
+
+	/* Сортируем номера строк, сами колонки не переставляем */
+	std::vector<std::size_t> rows(table.size());
+	for (std::size_t row = 0; row < rows.size(); ++row)
+		rows[row] = row;
+
+	auto less = [&table](std::size_t left, std::size_t right)
+	{
+		if (int order = table.get(Field::LastName, left).compare(table.get(Field::LastName, right)))
+			return order < 0;
+		if (int order = table.get(Field::FirstName, left).compare(table.get(Field::FirstName, right)))
+			return order < 0;
+		return table.get(Field::Patronymic, left) < table.get(Field::Patronymic, right);
+	};
+	parallelSort(rows, less, threads);
+
+	PersonTable sorted;
+	sorted.reserve(rows.size());
+	for (std::size_t i = 0; i < rows.size(); ++i)
+		if (i == 0 || less(rows[i - 1], rows[i]))
+			sorted.push_back(table.get(Field::LastName, rows[i]), table.get(Field::FirstName, rows[i]),
+				table.get(Field::Patronymic, rows[i]));
+	return sorted;
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+﻿#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "list.hpp"
+#include "PersonSort.hpp"
+
+/*
+*  Проверка sortUnique для стека: результат отсортирован без повторов, а при исключении
+*  (нехватка памяти при копировании, сортировке, запуске потока или сборке результата) стек не меняется.
+*  Глобальный operator new отказывает, когда разрешенные выделения кончаются; отказ повторяется
+*  на каждом выделении разрешенного числа, пока sortUnique не пройдет целиком.
+*      g++ -std=c++17 -g -pthread -fsanitize=address,undefined PersonSort_test.cpp -o PersonSort_test
+*/
+
+
+static std::atomic<long> allocations_left{ -1 }; /* Сколько выделений еще разрешено, -1 - без ограничений */
+
+void* operator new(std::size_t size)
+{
+	long left = allocations_left.load(std::memory_order_relaxed);
+	while (left >= 0)
+	{
+		if (left == 0)
+			throw std::bad_alloc();
+		if (allocations_left.compare_exchange_weak(left, left - 1, std::memory_order_relaxed))
+			break;
+	}
+	if (void* pointer = std::malloc(size ? size : 1))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+}
+
+/* Длинные имена не влезают в буфер короткой строки, и копирование людей выделяет память */
+static Person makePerson(std::size_t number, bool long_names)
+{
+	const std::string suffix = long_names ? "-long-enough-to-allocate" : "";
+	return Person("Last" + std::to_string(number % 97) + suffix, "First" + std::to_string(number % 13) + suffix,
+		"Patronymic" + std::to_string(number % 7) + suffix);
+}
+
+template<typename Container>
+static std::vector<Person> contents(const stack<Person, Container>& persons)
+{
+	return std::vector<Person>(persons.getContainer().begin(), persons.getContainer().end());
+}
+
+static bool same(const std::vector<Person>& left, const std::vector<Person>& right)
+{
+	if (left.size() != right.size())
+		return false;
+	for (std::size_t i = 0; i < left.size(); ++i)
+		if (PersonLess()(left[i], right[i]) || PersonLess()(right[i], left[i]))
+			return false;
+	return true;
+}
+
+/* Отсортирован строго по возрастанию снизу вверх, то есть без повторов */
+static bool sortedUnique(const std::vector<Person>& persons)
+{
+	for (std::size_t i = 1; i < persons.size(); ++i)
+		if (!PersonLess()(persons[i - 1], persons[i]))
+			return false;
+	return true;
+}
+
+template<typename Container>
+static void testResult(std::size_t size, std::size_t threads, const char* what)
+{
+	stack<Person, Container> persons;
+	for (std::size_t i = 0; i < size; ++i)
+		persons.push(makePerson(i * 7919, true));
+	sortUnique(persons, threads);
+
+	const std::vector<Person> result = contents(persons);
+	check(sortedUnique(result) && result.size() == std::min<std::size_t>(size, 97 * 13 * 7), what);
+}
+
+/* Запрещает выделения после allowed-го, пока sortUnique не пройдет; после каждого отказа стек должен остаться прежним */
+static void testFailures(std::size_t size, std::size_t threads, bool long_names, std::size_t step, const char* what)
+{
+	stack<Person> persons;
+	for (std::size_t i = 0; i < size; ++i)
+		persons.push(makePerson(i * 7919, long_names));
+	const std::vector<Person> original = contents(persons);
+
+	bool intact = true;
+	bool finished = false;
+	std::size_t failed = 0;
+	for (long allowed = 0; !finished; allowed += allowed < 64 ? 1 : static_cast<long>(step))
+	{
+		allocations_left.store(allowed);
+		try
+		{
+			sortUnique(persons, threads);
+			finished = true;
+		}
+		catch (const std::bad_alloc&)
+		{
+			++failed;
+		}
+		allocations_left.store(-1);
+		if (!finished)
+			intact = intact && same(contents(persons), original);
+	}
+	check(failed > 0, what);
+	check(intact, "sortUnique leaves the stack unchanged after an exception");
+	check(sortedUnique(contents(persons)), "sortUnique succeeds once memory is available");
+}
+
+
+int main()
+{
+	testResult<std::deque<Person>>(3000, 1, "sortUnique on deque sorts and removes duplicates");
+	testResult<list<Person>>(3000, 1, "sortUnique on list sorts and removes duplicates");
+	testResult<std::deque<Person>>(70000, 4, "sortUnique on 4 threads sorts and removes duplicates");
+
+	testFailures(300, 1, true, 1, "sortUnique throws when memory runs out on one thread");
+	testFailures(40000, 2, false, 2003, "sortUnique throws when memory runs out on 2 threads"); /* Короткие имена: отказы приходятся на буферы и потоки */
+
+	if (failures)
+		return 1;
+	std::cout << "PersonSort_test: OK\n";
+	return 0;
+}
@@ -0,0 +1,206 @@
+﻿#ifndef _PersonTable_hpp
+#define _PersonTable_hpp
+
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "stack.hpp"
+#include "Person.hpp"
+
+/*
+*  Колоночная таблица людей (structure of arrays).
+*  Каждое поле хранится отдельной колонкой: все байты подряд в одной строке и массив смещений,
+*  поэтому скан одного поля идет по непрерывной памяти и не трогает остальные.
+*  Строка таблицы i - это байты [offsets[i], offsets[i + 1]) каждой колонки.
+*  Однопоточная.
+*/
+class PersonTable final
+{
+public:
+	/* Поля человека */
+	enum class Field
+	{
+		LastName,
+		FirstName,
+		Patronymic
+	};
+
+	/* Конструкторы и деструктор */
+	PersonTable() = default;
+	template<typename Container, typename Check>
+	explicit PersonTable(const stack<Person, Container, Check>& stack); /* Раскладывает стек по колонкам в порядке контейнера */
+	~PersonTable() = default;
+
+	/* Методы */
+	std::size_t size() const noexcept; /* Количество строк */
+	bool empty() const noexcept; /* Если строк нет, возвращает true, иначе false */
+	void reserve(std::size_t rows); /* Резервирует место под смещения rows строк */
+
+	void push_back(std::string_view last_name, std::string_view first_name, std::string_view patronymic); /* Добавляет строку */
+	void push_back(const Person& person); /* Добавляет строку из Person */
+
+	std::string_view get(Field field, std::size_t row) const noexcept; /* Значение поля в строке row */
+	Person getPerson(std::size_t row) const; /* Собирает Person из строки row */
+	stack<Person> toStack() const; /* Собирает стек в порядке строк */
+
+	std::size_t countEqual(Field field, std::string_view value) const noexcept; /* Количество строк, где поле равно value */
+	std::size_t countPrefix(Field field, std::string_view prefix) const noexcept; /* Количество строк, где поле начинается с prefix */
+	std::vector<std::size_t> filterEqual(Field field, std::string_view value) const; /* Номера строк, где поле равно value */
+	std::vector<std::size_t> filterPrefix(Field field, std::string_view prefix) const; /* Номера строк, где поле начинается с prefix */
+private:
+	/* Колонка: байты всех значений подряд и смещения их начал, offsets.size() == size() + 1 */
+	struct Column final
+	{
+		std::vector<std::size_t> offsets{ 0 };
+		std::string bytes{};
+	};
+
+	const Column& column(Field field) const noexcept;
+
+	/* Проходит по колонке и вызывает action(row) для строк, где значение длины не меньше value и префикс совпал;
+	*  при exact - только для строк, где длина равна длине value */
+	template<typename Action>
+	void scan(Field field, std::string_view value, bool exact, Action action) const;
+
+	Column columns[3];
+};
+
+
+template<typename Container, typename Check>
+PersonTable::PersonTable(const stack<Person, Container, Check>& stack)
+{
+	reserve(stack.size());
+	for (const Person& person : stack.getContainer())
+		push_back(person);
+}
+
+std::size_t PersonTable::size() const noexcept
+{
+	return columns[0].offsets.size() - 1;
+}
+
+bool PersonTable::empty() const noexcept
+{
+	return size() == 0;
+}
+
+void PersonTable::reserve(std::size_t rows)
+{
+	for (Column& column : columns)
+		column.offsets.reserve(rows + 1);
+}
+
+void PersonTable::push_back(std::string_view last_name, std::string_view first_name, std::string_view patronymic)
+{
+	const std::string_view values[3] = { last_name, first_name, patronymic };
+	const std::size_t rows = size();
+	std::size_t i = 0;
+	try
+	{
+		for (; i < 3; ++i) /* append и push_back растут геометрически, reserve здесь сделал бы загрузку квадратичной */
+		{
+			columns[i].bytes.append(values[i]);
+			columns[i].offsets.push_back(columns[i].bytes.size());
+		}
+	}
+	catch (...)
+	{ /* Откатываем уже дописанные колонки, чтобы таблица не разъехалась */
+		for (std::size_t j = 0; j <= i && j < 3; ++j)
+		{
+			columns[j].offsets.resize(rows + 1);
+			columns[j].bytes.resize(columns[j].offsets.back());
+		}
+		throw;
+	}
+}
+
+void PersonTable::push_back(const Person& person)
+{
+	push_back(person.getLastName(), person.getFirstName(), person.getPatronymic());
+}
+
+std::string_view PersonTable::get(Field field, std::size_t row) const noexcept
+{
+	const Column& values = column(field);
+	return std::string_view(values.bytes.data() + values.offsets[row], values.offsets[row + 1] - values.offsets[row]);
+}
+
+Person PersonTable::getPerson(std::size_t row) const
+{
+	return Person(std::string(get(Field::LastName, row)), std::string(get(Field::FirstName, row)),
+		std::string(get(Field::Patronymic, row)));
+}
+
+stack<Person> PersonTable::toStack() const
+{
+	stack<Person> stack;
+	for (std::size_t row = 0; row < size(); ++row)
+		stack.push(getPerson(row));
+	return stack;
+}
+
+std::size_t PersonTable::countEqual(Field field, std::string_view value) const noexcept
+{
+	std::size_t count = 0;
+	scan(field, value, true, [&count](std::size_t) { ++count; });
+	return count;
+}
+
+std::size_t PersonTable::countPrefix(Field field, std::string_view prefix) const noexcept
+{
+	std::size_t count = 0;
+	scan(field, prefix, false, [&count](std::size_t) { ++count; });
+	return count;
+}
+
+std::vector<std::size_t> PersonTable::filterEqual(Field field, std::string_view value) const
+{
+	std::vector<std::size_t> rows;
+	scan(field, value, true, [&rows](std::size_t row) { rows.push_back(row); });
+	return rows;
+}
+
+std::vector<std::size_t> PersonTable::filterPrefix(Field field, std::string_view prefix) const
+{
+	std::vector<std::size_t> rows;
+	scan(field, prefix, false, [&rows](std::size_t row) { rows.push_back(row); });
+	return rows;
+}
+
+const PersonTable::Column& PersonTable::column(Field field) const noexcept
+{
+	return columns[static_cast<std::size_t>(field)];
+}
+
+template<typename Action>
+void PersonTable::scan(Field field, std::string_view value, bool exact, Action action) const
+{
+	const Column& values = column(field);
+	const std::size_t* offsets = values.offsets.data();
+	const char* bytes = values.bytes.data();
+	const std::size_t rows = size();
+	if (value.empty()) /* data() пустого значения и колонки может быть nullptr, а memcmp с ним - UB даже для 0 байт */
+	{
+		for (std::size_t row = 0; row < rows; ++row)
+			if (!exact || offsets[row + 1] == offsets[row])
+				action(row);
+		return;
+	}
+
+	for (std::size_t row = 0; row < rows; ++row)
+	{
+		/* Длины берем из смещений, байты сравниваем, только если длина подходит */
+		const std::size_t length = offsets[row + 1] - offsets[row];
+		if (exact ? length != value.size() : length < value.size())
+			continue;
+		if (std::memcmp(bytes + offsets[row], value.data(), value.size()) == 0)
+			action(row);
+	}
+}
+
+
+#endif
\ No newline at end of file
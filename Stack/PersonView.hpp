@@ -0,0 +1,70 @@
+﻿#ifndef _PersonView_hpp
+#define _PersonView_hpp
+
+
+#include <string>
+#include <string_view>
+
+#include "Person.hpp"
+
+/*
+*  Невладеющий аналог Person: три string_view в чужую память (арену, отображенный файл).
+*  Валиден, пока жива память, на которую ссылается.
+*/
+class PersonView final
+{
+public:
+	/* Конструкторы */
+	PersonView() = default;
+	PersonView(std::string_view last_name, std::string_view first_name, std::string_view patronymic) noexcept;
+	explicit PersonView(const Person& person) noexcept; /* Смотрит в строки person */
+	~PersonView() = default;
+
+	/* Методы */
+	std::string_view getLastName() const noexcept;
+	std::string_view getFirstName() const noexcept;
+	std::string_view getPatronymic() const noexcept;
+
+	Person toPerson() const; /* Собирает Person с собственными строками */
+private:
+
+	std::string_view last_name{};
+	std::string_view first_name{};
+	std::string_view patronymic{};
+};
+
+
+PersonView::PersonView(std::string_view last_name, std::string_view first_name, std::string_view patronymic) noexcept
+	: last_name(last_name),
+	first_name(first_name),
+	patronymic(patronymic)
+{}
+
+PersonView::PersonView(const Person& person) noexcept
+	: last_name(person.getLastName()),
+	first_name(person.getFirstName()),
+	patronymic(person.getPatronymic())
+{}
+
+std::string_view PersonView::getLastName() const noexcept
+{
+	return last_name;
+}
+
+std::string_view PersonView::getFirstName() const noexcept
+{
+	return first_name;
+}
+
+std::string_view PersonView::getPatronymic() const noexcept
+{
+	return patronymic;
+}
+
+Person PersonView::toPerson() const
+{
+	return Person(std::string(last_name), std::string(first_name), std::string(patronymic));
+}
+
+
+#endif
\ No newline at end of file
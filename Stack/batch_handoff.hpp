@@ -0,0 +1,138 @@
+﻿#ifndef _batch_handoff_hpp
+#define _batch_handoff_hpp
+
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "stack.hpp"
+#include "list.hpp"
+
+/*
+*  Передача элементов между потоками пачками (MPSC, частный случай - SPSC).
+*  Производитель копит элементы в собственном стеке batch без синхронизации и отдает его целиком
+*  через publish: одна CAS на всю пачку. Потребитель забирает все опубликованные пачки одной
+*  операцией exchange в take_all и получает их склеенными в один стек перевязкой узлов list,
+*  без копирования элементов. Порядок: внутри пачки LIFO, более поздние пачки лежат выше.
+*  Так как узлы только кладутся по одному и снимаются все сразу, проблемы ABA нет.
+*  Аллокатор должен быть потокобезопасным и все его копии равны (std::allocator подходит, pool_allocator - нет):
+*  узлы, выделенные производителем, освобождает потребитель.
+*/
+template<typename Type, typename Alloc = std::allocator<Type>>
+class batch_handoff final
+{
+public:
+	/* Типы */
+	using value_type = Type;
+	using batch = stack<Type, list<Type, Alloc>>;
+
+	/* Конструкторы и деструктор */
+	explicit batch_handoff(const Alloc& alloc = Alloc());
+	batch_handoff(const batch_handoff& oth) = delete;
+	batch_handoff(batch_handoff&& oth) = delete;
+	~batch_handoff();
+
+	/* Операторы */
+	batch_handoff& operator=(const batch_handoff& oth) = delete;
+	batch_handoff& operator=(batch_handoff&& oth) = delete;
+	/* Методы */
+	bool empty() const noexcept; /* Снимок: к моменту возврата могли опубликовать новую пачку */
+
+	void publish(batch&& items); /* Публикует пачку целиком, items становится пустым; пустая пачка игнорируется */
+	batch take_all(); /* Забирает все опубликованные пачки одним стеком */
+private:
+	/* Опубликованная пачка */
+	struct Node final
+	{
+		batch items;
+		Node* next = nullptr;
+
+		explicit Node(batch&& items) noexcept
+			: items(std::move(items))
+		{}
+	};
+
+	using RebindAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+	using AllocTraits = typename std::allocator_traits<RebindAlloc>;
+
+	void release(Node* node) noexcept; /* Уничтожает и освобождает узел */
+
+	/* Поля */
+	std::atomic<Node*> head{ nullptr }; /* Последняя опубликованная пачка */
+	RebindAlloc rebind_alloc{};
+};
+
+
+template<typename Type, typename Alloc>
+batch_handoff<Type, Alloc>::batch_handoff(const Alloc& alloc)
+	: rebind_alloc(alloc)
+{}
+
+template<typename Type, typename Alloc>
+batch_handoff<Type, Alloc>::~batch_handoff()
+{
+	for (Node* temp = head.load(std::memory_order_relaxed); temp;)
+	{
+		Node* next = temp->next;
+		release(temp);
+		temp = next;
+	}
+}
+
+template<typename Type, typename Alloc>
+bool batch_handoff<Type, Alloc>::empty() const noexcept
+{
+	return head.load(std::memory_order_acquire) == nullptr;
+}
+
+template<typename Type, typename Alloc>
+void batch_handoff<Type, Alloc>::publish(batch&& items)
+{
+	if (items.empty())
+		return;
+
+	Node* node = AllocTraits::allocate(rebind_alloc, 1);
+	AllocTraits::construct(rebind_alloc, node, std::move(items)); /* noexcept: стек переезжает перекладкой указателей */
+
+	/* release: потребитель, увидевший узел, видит и все элементы пачки */
+	node->next = head.load(std::memory_order_relaxed);
+	while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+		;
+}
+
+template<typename Type, typename Alloc>
+typename batch_handoff<Type, Alloc>::batch batch_handoff<Type, Alloc>::take_all()
+{
+	Node* taken = head.exchange(nullptr, std::memory_order_acquire);
+
+	/* Цепочка идет от новых пачек к старым; разворачиваем, чтобы класть старые первыми */
+	Node* oldest = nullptr;
+	while (taken)
+	{
+		Node* next = taken->next;
+		taken->next = oldest;
+		oldest = taken;
+		taken = next;
+	}
+
+	batch result;
+	for (Node* temp = oldest; temp;)
+	{
+		Node* next = temp->next;
+		result.append(std::move(temp->items)); /* list::append перевязывает узлы за O(1) */
+		release(temp);
+		temp = next;
+	}
+	return result;
+}
+
+template<typename Type, typename Alloc>
+void batch_handoff<Type, Alloc>::release(Node* node) noexcept
+{
+	AllocTraits::destroy(rebind_alloc, node);
+	AllocTraits::deallocate(rebind_alloc, node, 1);
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+﻿#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "bench.hpp"
+#include "../ByteScan.hpp"
+#include "../MappedFile.hpp"
+#include "../PersonKeeper.hpp"
+
+/*
+*  Разбор записей на поля: скалярный поиск разделителей против векторного (SSE2, с -mavx2 - AVX2).
+*  Разбор повторяет splitRecord без создания Person, чтобы мерить только сканирование;
+*  последняя строка - полный readPersons для сравнения. Для скалярного readPersons собрать с -DSTACK_NO_SIMD.
+*  Аргумент - число записей (по умолчанию 2M).
+*/
+template<typename FindEither, typename FindByte>
+std::size_t tokenize(const char* it, const char* end, FindEither find_either, FindByte find_byte)
+{
+	std::size_t field_bytes = 0;
+	while (it != end)
+	{
+		const char* token = it;
+		const char* delimiter = find_either(token, end, ' ', '\n'); /* Фамилия */
+		field_bytes += static_cast<std::size_t>(delimiter - token);
+		if (delimiter != end && *delimiter == ' ')
+		{
+			token = delimiter + 1;
+			delimiter = find_either(token, end, ' ', '\n'); /* Имя */
+			field_bytes += static_cast<std::size_t>(delimiter - token);
+			if (delimiter != end && *delimiter == ' ')
+			{
+				token = delimiter + 1;
+				delimiter = find_byte(token, end, '\n'); /* Отчество - остаток строки */
+				field_bytes += static_cast<std::size_t>(delimiter - token);
+			}
+		}
+		it = delimiter == end ? end : delimiter + 1;
+	}
+	return field_bytes;
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 2000000);
+	const std::string file_name = "parse_bench.txt";
+	const std::size_t bytes = writePersonFile(file_name, records);
+
+	{
+		MappedFile file(file_name);
+		const char* begin = file.data();
+		const char* end = begin + file.size();
+
+		double scalar = measure([&] { doNotOptimize(tokenize(begin, end, findEitherScalar, findByteScalar)); });
+		reportBytes("split fields, scalar", scalar, bytes, records);
+
+		double vector = measure([&] { doNotOptimize(tokenize(begin, end, findEither, findByte)); });
+#ifdef STACK_SIMD_SCAN
+		reportBytes("split fields, SIMD", vector, bytes, records);
+#else
+		reportBytes("split fields, SIMD disabled", vector, bytes, records);
+#endif
+
+		double full = measure([&] { doNotOptimize(PersonKeeper::instance().readPersons(file_name).size()); });
+		reportBytes("readPersons(file_name)", full, bytes, records);
+	}
+
+	std::remove(file_name.c_str());
+	return 0;
+}
@@ -0,0 +1,101 @@
+﻿#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+#include "../PersonIndex.hpp"
+
+/*
+*  Построение PersonIndex и поиск по полному имени и по каждому полю против линейного прохода по getContainer().
+*  Аргумент - число записей (по умолчанию 1M).
+*/
+
+
+static std::string_view fieldOf(const Person& person, PersonTable::Field field)
+{
+	switch (field)
+	{
+	case PersonTable::Field::LastName:
+		return person.getLastName();
+	case PersonTable::Field::FirstName:
+		return person.getFirstName();
+	default:
+		return person.getPatronymic();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 1000000);
+	const std::string file_name = "PersonIndex_bench.txt";
+	writePersonFile(file_name, records);
+	stack<Person> persons = PersonKeeper::instance().readPersons(file_name);
+	std::remove(file_name.c_str());
+
+	/* Запросы - люди из самого стека, каждый сотый */
+	std::vector<const Person*> queries;
+	for (const Person& person : persons.getContainer())
+		if (queries.size() * 100 < persons.size() && queries.size() < 1000)
+			queries.push_back(&person);
+
+	double build = measure([&] { PersonIndex index(persons); doNotOptimize(index); });
+	reportOps("PersonIndex build (per record)", build, persons.size());
+
+	PersonIndex index(persons);
+	std::size_t found = 0;
+	double hashed = measure([&]
+		{
+			for (const Person* query : queries)
+				found += index.find(query->getLastName(), query->getFirstName(), query->getPatronymic()).size();
+		});
+	reportOps("find full name, PersonIndex", hashed, queries.size());
+
+	/* Имена и отчества повторяются часто: поиск отдает тысячи строк, стоимость - на запрос */
+	const struct
+	{
+		const char* name;
+		PersonTable::Field field;
+	} field_cases[] = {
+		{ "find last name, PersonIndex", PersonTable::Field::LastName },
+		{ "find first name, PersonIndex", PersonTable::Field::FirstName },
+		{ "find patronymic, PersonIndex", PersonTable::Field::Patronymic }
+	};
+	for (const auto& field_case : field_cases)
+	{
+		double hashed_field = measure([&]
+			{
+				for (const Person* query : queries)
+					found += index.find(field_case.field, fieldOf(*query, field_case.field)).size();
+			});
+		reportOps(field_case.name, hashed_field, queries.size());
+
+		/* Индекс должен находить ровно тех, кого находит линейный проход */
+		for (std::size_t i = 0; i < std::min<std::size_t>(queries.size(), 5); ++i)
+		{
+			const std::string_view value = fieldOf(*queries[i], field_case.field);
+			const std::size_t expected = static_cast<std::size_t>(std::count_if(persons.getContainer().begin(), persons.getContainer().end(),
+				[&](const Person& person) { return fieldOf(person, field_case.field) == value; }));
+			if (index.find(field_case.field, value).size() != expected)
+			{
+				std::fprintf(stderr, "%s: index and linear scan disagree\n", field_case.name);
+				return 1;
+			}
+		}
+	}
+
+	const std::size_t scan_queries = std::min<std::size_t>(queries.size(), 20); /* Линейный проход долгий, хватает нескольких запросов */
+	double linear = measure([&]
+		{
+			for (std::size_t i = 0; i < scan_queries; ++i)
+				for (const Person& person : persons.getContainer())
+					found += person.getLastName() == queries[i]->getLastName() && person.getFirstName() == queries[i]->getFirstName()
+						&& person.getPatronymic() == queries[i]->getPatronymic();
+		});
+	reportOps("find full name, linear scan", linear, scan_queries);
+
+	doNotOptimize(found);
+	return 0;
+}
@@ -0,0 +1,77 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+#include "../PersonSort.hpp"
+
+/*
+*  Сортировка людей: std::sort против parallelSort на 1..N потоках, затем sortUnique для стека и таблицы.
+*  Аргументы: число записей (по умолчанию 1M, запрос - до 100M) и максимальное число потоков (по умолчанию по числу ядер).
+*/
+
+
+/* Лучшее время action над свежей копией values; копирование в замер не входит */
+template<typename Type, typename Action>
+double measureOnCopy(const std::vector<Type>& values, Action action)
+{
+	double best = 0;
+	for (int run = 0; run < bench_runs; ++run)
+	{
+		std::vector<Type> copy = values;
+		auto start = std::chrono::steady_clock::now();
+		action(copy);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (run == 0 || seconds < best)
+			best = seconds;
+	}
+	return best;
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 1000000);
+	const std::size_t max_threads = std::max<std::size_t>(argSize(argc, argv, std::thread::hardware_concurrency(), 2), 1);
+	const std::string file_name = "PersonSort_bench.txt";
+	writePersonFile(file_name, records);
+	PersonKeeper& keeper = PersonKeeper::instance();
+	const stack<Person> persons = keeper.readPersons(file_name);
+	const PersonTable table = keeper.readTable(file_name);
+	std::remove(file_name.c_str());
+
+	const std::vector<Person> values(persons.getContainer().begin(), persons.getContainer().end());
+	reportOps("std::sort", measureOnCopy(values, [](std::vector<Person>& copy)
+		{
+			std::sort(copy.begin(), copy.end(), PersonLess());
+		}), records);
+
+	char name[64];
+	for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		std::snprintf(name, sizeof(name), "parallelSort, %zu threads", threads);
+		reportOps(name, measureOnCopy(values, [threads](std::vector<Person>& copy)
+			{
+				parallelSort(copy, PersonLess(), threads);
+			}), records);
+	}
+
+	double stack_unique = 0;
+	for (int run = 0; run < bench_runs; ++run)
+	{
+		stack<Person> copy = persons;
+		auto start = std::chrono::steady_clock::now();
+		sortUnique(copy, max_threads);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (run == 0 || seconds < stack_unique)
+			stack_unique = seconds;
+	}
+	reportOps("sortUnique(stack<Person>)", stack_unique, records);
+
+	reportOps("sortUnique(PersonTable)", measure([&] { doNotOptimize(sortUnique(table, max_threads).size()); }), records);
+	return 0;
+}
@@ -0,0 +1,69 @@
+﻿#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+#include "../PersonTable.hpp"
+
+/*
+*  Фильтры по полю: PersonTable против прохода по getContainer() стека людей.
+*  Аргумент - число записей (по умолчанию 2M).
+*/
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 2000000);
+	const std::string file_name = "PersonTable_bench.txt";
+	writePersonFile(file_name, records);
+	PersonKeeper& keeper = PersonKeeper::instance();
+
+	double load_table = measure([&] { doNotOptimize(keeper.readTable(file_name).size()); });
+	reportOps("readTable (per record)", load_table, records);
+	double load_stack = measure([&] { doNotOptimize(keeper.readPersons(file_name).size()); });
+	reportOps("readPersons(file_name) (per record)", load_stack, records);
+
+	PersonTable table = keeper.readTable(file_name);
+	stack<Person> persons = keeper.readPersons(file_name);
+	std::remove(file_name.c_str());
+
+	const std::string value(table.get(PersonTable::Field::FirstName, 0)); /* Частое имя из самого файла */
+	const std::string prefix = value.substr(0, 2);
+	using Field = PersonTable::Field;
+
+	std::size_t count = 0;
+	double table_equal = measure([&] { count += table.countEqual(Field::FirstName, value); });
+	reportOps("countEqual, PersonTable (per row)", table_equal, records);
+	double stack_equal = measure([&]
+		{
+			for (const Person& person : persons.getContainer())
+				count += person.getFirstName() == value;
+		});
+	reportOps("countEqual, getContainer() (per row)", stack_equal, records);
+
+	double table_prefix = measure([&] { count += table.countPrefix(Field::FirstName, prefix); });
+	reportOps("countPrefix, PersonTable (per row)", table_prefix, records);
+	double stack_prefix = measure([&]
+		{
+			for (const Person& person : persons.getContainer())
+				count += person.getFirstName().compare(0, prefix.size(), prefix) == 0;
+		});
+	reportOps("countPrefix, getContainer() (per row)", stack_prefix, records);
+
+	std::vector<std::size_t> rows;
+	double table_filter = measure([&] { rows = table.filterPrefix(Field::LastName, prefix); });
+	reportOps("filterPrefix, PersonTable (per row)", table_filter, records);
+	std::vector<const Person*> matches;
+	double stack_filter = measure([&]
+		{
+			matches.clear();
+			for (const Person& person : persons.getContainer())
+				if (person.getLastName().compare(0, prefix.size(), prefix) == 0)
+					matches.push_back(&person);
+		});
+	reportOps("filterPrefix, getContainer() (per row)", stack_filter, records);
+
+	doNotOptimize(count);
+	doNotOptimize(rows.size() + matches.size());
+	return 0;
+}
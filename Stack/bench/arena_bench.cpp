@@ -0,0 +1,86 @@
+﻿#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+
+/*
+*  Аллокации на запись и время загрузки: readPersonViews в арену против readPersons.
+*  Аллокации считаются подменой глобального operator new, арена берет память у него же.
+*  Аргумент - число записей (по умолчанию 2M).
+*/
+
+
+static std::atomic<std::size_t> allocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size ? size : 1))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) /* Им пользуется std::pmr::new_delete_resource */
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	std::size_t align = static_cast<std::size_t>(alignment);
+	if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+template<typename Load>
+void run(const char* name, std::size_t bytes, std::size_t records, Load load)
+{
+	double seconds = measure(load);
+	std::size_t before = allocations.load();
+	load();
+	std::size_t count = allocations.load() - before;
+	reportBytes(name, seconds, bytes, records);
+	std::printf("%-48s %10.3f alloc/record %10zu total\n", name, static_cast<double>(count) / static_cast<double>(records), count);
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 2000000);
+	const std::string file_name = "arena_bench.txt";
+	const std::size_t bytes = writePersonFile(file_name, records);
+	PersonKeeper& keeper = PersonKeeper::instance();
+
+	run("readPersons(file_name)", bytes, records, [&] { doNotOptimize(keeper.readPersons(file_name).size()); });
+	run("readPersonViews, monotonic arena", bytes, records, [&]
+		{
+			std::pmr::monotonic_buffer_resource arena;
+			doNotOptimize(keeper.readPersonViews(file_name, arena).size());
+		});
+
+	std::remove(file_name.c_str());
+	return 0;
+}
@@ -0,0 +1,145 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "../batch_handoff.hpp"
+#include "../concurrent_stack.hpp"
+
+/*
+*  batch_handoff: пропускная способность SPSC и MPSC при разных размерах пачки
+*  и, для сравнения, поэлементная передача через concurrent_stack.
+*  Задержка - половина времени обмена одним элементом туда и обратно (пинг-понг двух потоков).
+*  Аргументы: элементов на производителя (по умолчанию 1M), максимум производителей (по умолчанию по числу ядер).
+*/
+
+
+/* Производители кладут по n элементов пачками по batch_size, потребитель забирает, пока не соберет все */
+double runHandoff(std::size_t producers, std::size_t n, std::size_t batch_size)
+{
+	using handoff = batch_handoff<std::uint64_t>;
+	return measure([&]
+		{
+			handoff channel;
+			std::vector<std::thread> threads;
+			for (std::size_t p = 0; p < producers; ++p)
+				threads.emplace_back([&channel, n, batch_size]
+					{
+						handoff::batch items;
+						for (std::size_t i = 0; i < n; ++i)
+						{
+							items.push(i);
+							if (items.size() == batch_size)
+								channel.publish(std::move(items));
+						}
+						channel.publish(std::move(items));
+					});
+
+			std::uint64_t sum = 0;
+			for (std::size_t left = producers * n; left;)
+			{
+				handoff::batch taken = channel.take_all();
+				if (taken.empty())
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				left -= taken.size();
+				std::uint64_t value = 0;
+				while (taken.try_pop(value))
+					sum += value;
+			}
+			doNotOptimize(sum);
+			for (auto& thread : threads)
+				thread.join();
+		});
+}
+
+/* То же через concurrent_stack: синхронизация на каждом элементе */
+double runPerElement(std::size_t producers, std::size_t n)
+{
+	return measure([&]
+		{
+			concurrent_stack<std::uint64_t> channel;
+			std::vector<std::thread> threads;
+			for (std::size_t p = 0; p < producers; ++p)
+				threads.emplace_back([&channel, n]
+					{
+						for (std::size_t i = 0; i < n; ++i)
+							channel.push(i);
+					});
+
+			std::uint64_t sum = 0, value = 0;
+			for (std::size_t left = producers * n; left;)
+			{
+				if (!channel.try_pop(value))
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				sum += value;
+				--left;
+			}
+			doNotOptimize(sum);
+			for (auto& thread : threads)
+				thread.join();
+		});
+}
+
+/* Пинг-понг одним элементом через два канала; возвращает время rounds обменов */
+double runPingPong(std::size_t rounds)
+{
+	using handoff = batch_handoff<std::uint64_t>;
+	return measure([&]
+		{
+			handoff ping, pong;
+			auto relay = [rounds](handoff& in, handoff& out, bool starts)
+			{
+				handoff::batch items;
+				if (starts)
+				{
+					items.push(0);
+					out.publish(std::move(items));
+				}
+				for (std::size_t i = starts ? 1 : 0; i < rounds; ++i)
+				{
+					while ((items = in.take_all()).empty())
+						std::this_thread::yield();
+					out.publish(std::move(items));
+				}
+				if (starts) /* Последний ответ */
+					while (in.take_all().empty())
+						std::this_thread::yield();
+			};
+			std::thread other(relay, std::ref(ping), std::ref(pong), false);
+			relay(pong, ping, true);
+			other.join();
+		});
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t n = argSize(argc, argv, 1000000);
+	const std::size_t max_producers = argSize(argc, argv, std::max<std::size_t>(std::thread::hardware_concurrency(), 1), 2);
+
+	char name[64];
+	for (std::size_t producers = 1; producers <= max_producers; producers *= 2)
+	{
+		const char* kind = producers == 1 ? "SPSC" : "MPSC";
+		for (std::size_t batch_size : { 1, 16, 256, 4096 })
+		{
+			std::snprintf(name, sizeof(name), "%s x%zu, batch_handoff, batch %zu", kind, producers, batch_size);
+			reportOps(name, runHandoff(producers, n, batch_size), producers * n);
+		}
+		std::snprintf(name, sizeof(name), "%s x%zu, concurrent_stack per element", kind, producers);
+		reportOps(name, runPerElement(producers, n), producers * n);
+	}
+
+	const std::size_t rounds = std::max<std::size_t>(n / 100, 1);
+	reportOps("latency, one element one way", runPingPong(rounds) / 2, rounds);
+	return 0;
+}
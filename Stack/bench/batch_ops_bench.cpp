@@ -0,0 +1,66 @@
+﻿#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include "bench.hpp"
+#include "../list.hpp"
+#include "../stack.hpp"
+
+/*
+*  Пакетные операции стека на размерах пачки от 1 до 4096: push_range и pop_n(n, out)
+*  против цикла push и цикла top + pop, для stack на std::deque и на list.
+*  Всего через стек проходит total элементов при любом размере пачки.
+*  Аргумент - total (по умолчанию 1M).
+*/
+template<typename Container>
+void run(const char* container_name, std::size_t total)
+{
+	char name[80];
+	for (std::size_t batch = 1; batch <= 4096; batch *= 4)
+	{
+		std::vector<std::uint64_t> input(batch), output(batch);
+		for (std::size_t i = 0; i < batch; ++i)
+			input[i] = i;
+		const std::size_t rounds = total / batch;
+		stack<std::uint64_t, Container> values;
+
+		double loop = measure([&]
+			{
+				for (std::size_t round = 0; round < rounds; ++round)
+				{
+					for (std::uint64_t value : input)
+						values.push(value);
+					for (std::size_t i = 0; i < batch; ++i)
+					{
+						output[i] = values.top();
+						values.pop();
+					}
+				}
+				doNotOptimize(output[0]);
+			});
+		std::snprintf(name, sizeof(name), "%s, batch %zu, push/top+pop loop", container_name, batch);
+		reportOps(name, loop, 2 * rounds * batch);
+
+		double bulk = measure([&]
+			{
+				for (std::size_t round = 0; round < rounds; ++round)
+				{
+					values.push_range(input.begin(), input.end());
+					values.pop_n(batch, output.begin());
+				}
+				doNotOptimize(output[0]);
+			});
+		std::snprintf(name, sizeof(name), "%s, batch %zu, push_range/pop_n", container_name, batch);
+		reportOps(name, bulk, 2 * rounds * batch);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t total = argSize(argc, argv, 1000000);
+	run<std::deque<std::uint64_t>>("deque", total);
+	run<list<std::uint64_t>>("list", total);
+	return 0;
+}
@@ -0,0 +1,129 @@
+﻿#ifndef _bench_hpp
+#define _bench_hpp
+
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+/*
+*  Общие помощники бенчмарков. Каждый файл каталога - самостоятельный main, заголовки проекта самодостаточны:
+*      g++ -std=c++17 -O2 -pthread -I.. pool_allocator_bench.cpp -o pool_allocator_bench
+*  Размер задачи можно передать первым аргументом, иначе берется значение по умолчанию.
+*  Печатается лучшее время из нескольких прогонов: нс на операцию, записи/с или МБ/с.
+*/
+
+
+/* Сколько раз повторяется замер, берется лучший */
+constexpr int bench_runs = 5;
+
+/* Не дает компилятору выбросить вычисление value */
+template<typename Type>
+inline void doNotOptimize(const Type& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "g"(&value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+/* Лучшее из bench_runs время body() в секундах */
+template<typename Body>
+inline double measure(Body body)
+{
+	double best = 0;
+	for (int run = 0; run < bench_runs; ++run)
+	{
+		auto start = std::chrono::steady_clock::now();
+		body();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (run == 0 || seconds < best)
+			best = seconds;
+	}
+	return best;
+}
+
+/* Размер задачи: argv[index], если передан, иначе fallback */
+inline std::size_t argSize(int argc, char** argv, std::size_t fallback, int index = 1)
+{
+	return argc > index ? static_cast<std::size_t>(std::strtoull(argv[index], nullptr, 10)) : fallback;
+}
+
+inline void reportOps(const char* name, double seconds, std::size_t ops)
+{
+	std::printf("%-48s %10.2f ns/op %12.0f op/s\n", name, seconds * 1e9 / static_cast<double>(ops), static_cast<double>(ops) / seconds);
+}
+
+inline void reportBytes(const char* name, double seconds, std::size_t bytes, std::size_t records)
+{
+	std::printf("%-48s %10.1f MB/s %12.0f rec/s\n", name, static_cast<double>(bytes) / seconds / 1e6,
+		static_cast<double>(records) / seconds);
+}
+
+/* Пиковый RSS процесса в КБ, 0 там, где узнать нельзя */
+inline std::size_t peakRssKb()
+{
+#ifndef _WIN32
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+	return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+	return 0;
+#endif
+}
+
+/* Имя из номера: заглавная буква и строчные, как у настоящих фамилий, длина 6-12 */
+inline std::string benchName(std::uint64_t number, const char* suffix)
+{
+	std::string name(1, static_cast<char>('A' + number % 26));
+	number /= 26;
+	for (std::size_t i = 0; i < 4 || number; ++i, number /= 26)
+		name += static_cast<char>('a' + number % 26);
+	return name + suffix;
+}
+
+/*
+*  Текстовый файл людей со скошенным распределением, как в реальных данных:
+*  фамилий много (до 100k различных), имен и отчеств - по паре тысяч, частые встречаются гораздо чаще редких.
+*  Возвращает размер файла в байтах.
+*/
+inline std::size_t writePersonFile(const std::string& file_name, std::size_t records, std::uint64_t seed = 1)
+{
+	std::mt19937_64 random(seed);
+	auto skewed = [&random](std::uint64_t distinct)
+	{ /* Минимум из двух равномерных: плотность падает к хвосту */
+		std::uniform_int_distribution<std::uint64_t> uniform(0, distinct - 1);
+		std::uint64_t a = uniform(random), b = uniform(random);
+		return a < b ? a : b;
+	};
+
+	std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+	std::string line;
+	std::size_t bytes = 0;
+	for (std::size_t i = 0; i < records; ++i)
+	{
+		line = benchName(skewed(100000), "ov");
+		line += ' ';
+		line += benchName(skewed(2000), "");
+		line += ' ';
+		line += benchName(skewed(2000), "ovich");
+		line += '\n';
+		file.write(line.data(), static_cast<std::streamsize>(line.size()));
+		bytes += line.size();
+	}
+	return bytes;
+}
+
+
+#endif
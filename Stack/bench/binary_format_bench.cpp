@@ -0,0 +1,33 @@
+﻿#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+
+/*
+*  Время загрузки стека людей: текстовый файл против бинарного формата.
+*  Аргумент - число записей (по умолчанию 2M).
+*/
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 2000000);
+	const std::string text_name = "binary_bench.txt";
+	const std::string binary_name = "binary_bench.pkb";
+	const std::size_t bytes = writePersonFile(text_name, records);
+	PersonKeeper& keeper = PersonKeeper::instance();
+	keeper.convertTextToBinary(text_name, binary_name);
+
+	double text = measure([&] { doNotOptimize(keeper.readPersons(text_name).size()); });
+	reportBytes("load text, readPersons(file_name)", text, bytes, records);
+
+	double binary = measure([&] { doNotOptimize(keeper.readPersonsBinary(binary_name).size()); });
+	reportBytes("load binary, readPersonsBinary", binary, bytes, records);
+
+	double convert = measure([&] { keeper.convertTextToBinary(text_name, binary_name); });
+	reportBytes("convertTextToBinary", convert, bytes, records);
+
+	std::remove(text_name.c_str());
+	std::remove(binary_name.c_str());
+	return 0;
+}
@@ -0,0 +1,59 @@
+﻿#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "bench.hpp"
+#include "../stack.hpp"
+#include "../bounded_stack.hpp"
+
+/*
+*  stack на bounded_stack против stack на std::deque по умолчанию:
+*  короткие циклы create/push/pop/destroy и длинная серия push/pop на уже созданном стеке.
+*  Аргумент - число циклов (по умолчанию 1M).
+*/
+constexpr std::size_t capacity = 64;
+
+template<typename Stack>
+void run(const char* cycle_name, const char* steady_name, std::size_t cycles)
+{
+	double cycle = measure([&]
+		{
+			for (std::size_t i = 0; i < cycles; ++i)
+			{
+				Stack values;
+				for (std::size_t j = 0; j < capacity; ++j)
+					values.push(i + j);
+				std::uint64_t sum = 0;
+				while (!values.empty())
+				{
+					sum += values.top();
+					values.pop();
+				}
+				doNotOptimize(sum);
+			}
+		});
+	reportOps(cycle_name, cycle, cycles);
+
+	Stack values;
+	double steady = measure([&]
+		{
+			for (std::size_t i = 0; i < cycles; ++i)
+			{
+				values.push(i);
+				values.push(i + 1);
+				values.pop();
+				doNotOptimize(values.top());
+				values.pop();
+			}
+		});
+	reportOps(steady_name, steady, 4 * cycles);
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t cycles = argSize(argc, argv, 1000000);
+	run<stack<std::uint64_t, bounded_stack<std::uint64_t, capacity>>>("64-element cycle, bounded_stack",
+		"steady push/pop, bounded_stack", cycles);
+	run<stack<std::uint64_t>>("64-element cycle, std::deque", "steady push/pop, std::deque", cycles);
+	return 0;
+}
@@ -0,0 +1,79 @@
+﻿#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "../stack.hpp"
+
+/*
+*  Политики проверки пустоты stack: throw_on_empty, assert_on_empty и no_empty_check.
+*  drain* - по функции на политику, отдельные и не встраиваемые, чтобы сравнить их код:
+*      g++ -std=c++17 -O2 -I.. -S check_policy_bench.cpp -o - | c++filt | less   (assert_on_empty без -DNDEBUG проверяет)
+*  Цикл снимает ровно n элементов без проверки empty(), поэтому компилятор не может сам доказать непустоту.
+*  Аргумент - число элементов (по умолчанию 1M).
+*/
+template<typename Check>
+using policy_stack = stack<std::uint64_t, std::vector<std::uint64_t>, Check>;
+
+template<typename Check>
+[[gnu::noinline]] std::uint64_t drain(policy_stack<Check>& values, std::size_t n)
+{
+	std::uint64_t sum = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		sum += values.top();
+		values.pop();
+	}
+	return sum;
+}
+
+[[gnu::noinline]] std::uint64_t drainThrow(policy_stack<throw_on_empty>& values, std::size_t n)
+{
+	return drain(values, n);
+}
+
+[[gnu::noinline]] std::uint64_t drainAssert(policy_stack<assert_on_empty>& values, std::size_t n)
+{
+	return drain(values, n);
+}
+
+[[gnu::noinline]] std::uint64_t drainUnchecked(policy_stack<no_empty_check>& values, std::size_t n)
+{
+	return drain(values, n);
+}
+
+template<typename Check, typename Drain>
+void run(const char* name, std::size_t n, Drain drain_all)
+{
+	policy_stack<Check> values;
+	std::vector<std::uint64_t> input(n);
+	for (std::size_t i = 0; i < n; ++i)
+		input[i] = i;
+
+	double best = 0;
+	for (int run = 0; run < bench_runs; ++run)
+	{
+		values.push_range(input.begin(), input.end());
+		auto start = std::chrono::steady_clock::now();
+		doNotOptimize(drain_all(values, n));
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (run == 0 || seconds < best)
+			best = seconds;
+	}
+	reportOps(name, best, n);
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t n = argSize(argc, argv, 1000000);
+	run<throw_on_empty>("top + pop, throw_on_empty", n, drainThrow);
+#ifdef NDEBUG
+	run<assert_on_empty>("top + pop, assert_on_empty (NDEBUG)", n, drainAssert);
+#else
+	run<assert_on_empty>("top + pop, assert_on_empty", n, drainAssert);
+#endif
+	run<no_empty_check>("top + pop, no_empty_check", n, drainUnchecked);
+	return 0;
+}
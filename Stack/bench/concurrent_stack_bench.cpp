@@ -0,0 +1,83 @@
+﻿#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "../stack.hpp"
+#include "../concurrent_stack.hpp"
+
+/*
+*  Пропускная способность concurrent_stack против std::mutex + stack<T> на 1..N потоках.
+*  Каждый поток делает n пар push + try_pop, время - общее на все потоки.
+*  Аргументы: максимальное число потоков (по умолчанию по числу ядер) и пар на поток (по умолчанию 1M).
+*/
+
+
+/* Базовый вариант: однопоточный stack под мьютексом */
+template<typename Type>
+class mutex_stack final
+{
+public:
+	void push(const Type& value)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		values.push(value);
+	}
+
+	bool try_pop(Type& value)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (values.empty())
+			return false;
+		value = values.top();
+		values.pop();
+		return true;
+	}
+private:
+	std::mutex mutex{};
+	stack<Type> values{};
+};
+
+template<typename Stack>
+double runPairs(std::size_t threads, std::size_t n)
+{
+	return measure([&]
+		{
+			Stack values;
+			std::vector<std::thread> workers;
+			for (std::size_t t = 0; t < threads; ++t)
+				workers.emplace_back([&values, n, t]
+					{
+						std::uint64_t value = 0, sum = 0;
+						for (std::size_t i = 0; i < n; ++i)
+						{
+							values.push(t + i);
+							if (values.try_pop(value))
+								sum += value;
+						}
+						doNotOptimize(sum);
+					});
+			for (auto& worker : workers)
+				worker.join();
+		});
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t max_threads = argSize(argc, argv, std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+	const std::size_t n = argSize(argc, argv, 1000000, 2);
+
+	char name[64];
+	for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		std::snprintf(name, sizeof(name), "%zu threads, concurrent_stack", threads);
+		reportOps(name, runPairs<concurrent_stack<std::uint64_t>>(threads, n), 2 * threads * n);
+		std::snprintf(name, sizeof(name), "%zu threads, std::mutex + stack", threads);
+		reportOps(name, runPairs<mutex_stack<std::uint64_t>>(threads, n), 2 * threads * n);
+	}
+	return 0;
+}
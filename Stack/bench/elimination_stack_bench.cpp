@@ -0,0 +1,55 @@
+﻿#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "../concurrent_stack.hpp"
+#include "../elimination_stack.hpp"
+
+/*
+*  Масштабирование elimination_stack против обычного concurrent_stack на 1..N потоках.
+*  Половина потоков только кладет, половина только снимает - встречные push и pop,
+*  на которых элиминация и должна выигрывать под высокой конкуренцией.
+*  Аргументы: максимальное число потоков (по умолчанию по числу ядер, минимум 2) и операций на поток (по умолчанию 1M).
+*/
+template<typename Stack>
+double runOpposite(std::size_t threads, std::size_t n)
+{
+	return measure([&]
+		{
+			Stack values;
+			std::vector<std::thread> workers;
+			for (std::size_t t = 0; t < threads; ++t)
+				workers.emplace_back([&values, n, t]
+					{
+						std::uint64_t value = 0, sum = 0;
+						for (std::size_t i = 0; i < n; ++i)
+							if (t % 2 == 0)
+								values.push(i);
+							else if (values.try_pop(value))
+								sum += value;
+						doNotOptimize(sum);
+					});
+			for (auto& worker : workers)
+				worker.join();
+		});
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t max_threads = std::max<std::size_t>(argSize(argc, argv, std::thread::hardware_concurrency()), 2);
+	const std::size_t n = argSize(argc, argv, 1000000, 2);
+
+	char name[64];
+	for (std::size_t threads = 2; threads <= max_threads; threads *= 2)
+	{
+		std::snprintf(name, sizeof(name), "%zu threads, concurrent_stack", threads);
+		reportOps(name, runOpposite<concurrent_stack<std::uint64_t>>(threads, n), threads * n);
+		std::snprintf(name, sizeof(name), "%zu threads, elimination_stack", threads);
+		reportOps(name, runOpposite<elimination_stack<std::uint64_t>>(threads, n), threads * n);
+	}
+	return 0;
+}
@@ -0,0 +1,169 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "../epoch_reclamation.hpp"
+#include "../list.hpp"
+
+/*
+*  Стоимость epoch_reclamation на операцию.
+*  Стек Трайбера на 1..N потоках, каждый поток делает n пар push + try_pop. Снятые узлы:
+*  - удаляются сразу (безопасно только в одном потоке, нижняя граница),
+*  - копятся и удаляются после остановки потоков (память не переиспользуется, поэтому дороже по кэшу),
+*  - уходят в retire под epoch_guard. Разница с первыми двумя - цена guard, retire и пачечного освобождения.
+*  Отдельно однопоточный list: std::allocator против deferred_allocator.
+*  Аргументы: максимальное число потоков (по умолчанию по числу ядер) и пар на поток (по умолчанию 1M).
+*/
+
+
+/* Что делать со снятым узлом */
+enum class Reclaim
+{
+	Immediate, /* delete сразу, только для одного потока */
+	AfterRun, /* В graveyard, удаляется после остановки потоков */
+	Epoch /* retire в epoch_domain */
+};
+
+/* Стек Трайбера со способом освобождения Mode */
+template<Reclaim Mode>
+class treiber_stack final
+{
+public:
+	struct Node final
+	{
+		std::uint64_t value;
+		Node* next;
+	};
+
+	explicit treiber_stack(epoch_domain& domain) noexcept
+		: domain(domain)
+	{}
+
+	~treiber_stack()
+	{
+		for (Node* temp = head.load(std::memory_order_relaxed); temp;)
+		{
+			Node* next = temp->next;
+			delete temp;
+			temp = next;
+		}
+	}
+
+	void push(std::uint64_t value)
+	{
+		Node* node = new Node{ value, head.load(std::memory_order_relaxed) };
+		while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+			;
+	}
+
+	bool try_pop(epoch_participant& participant, std::vector<Node*>& graveyard, std::uint64_t& value)
+	{
+		Node* node;
+		if constexpr (Mode == Reclaim::Epoch)
+		{
+			epoch_guard guard(participant);
+			if (!unlink(node, value))
+				return false;
+		}
+		else if (!unlink(node, value))
+			return false;
+
+		if constexpr (Mode == Reclaim::Epoch)
+			domain.retire(node);
+		else if constexpr (Mode == Reclaim::AfterRun)
+			graveyard.push_back(node);
+		else
+			delete node;
+		return true;
+	}
+private:
+	bool unlink(Node*& node, std::uint64_t& value) noexcept
+	{
+		node = head.load(std::memory_order_acquire);
+		while (node && !head.compare_exchange_weak(node, node->next, std::memory_order_acquire, std::memory_order_acquire))
+			;
+		if (!node)
+			return false;
+		value = node->value;
+		return true;
+	}
+
+	epoch_domain& domain;
+	std::atomic<Node*> head{ nullptr };
+};
+
+template<Reclaim Mode>
+double runPairs(std::size_t threads, std::size_t n)
+{
+	using stack_type = treiber_stack<Mode>;
+	return measure([&]
+		{
+			epoch_domain domain;
+			stack_type values(domain);
+			std::vector<std::vector<typename stack_type::Node*>> graveyards(threads);
+			std::vector<std::thread> workers;
+			for (std::size_t t = 0; t < threads; ++t)
+				workers.emplace_back([&, t]
+					{
+						epoch_participant participant(domain);
+						std::uint64_t value = 0, sum = 0;
+						for (std::size_t i = 0; i < n; ++i)
+						{
+							values.push(t + i);
+							if (values.try_pop(participant, graveyards[t], value))
+								sum += value;
+						}
+						doNotOptimize(sum);
+					});
+			for (auto& worker : workers)
+				worker.join();
+			for (auto& graveyard : graveyards) /* Без освобождения во время работы: все снятое - после остановки потоков */
+				for (auto node : graveyard)
+					delete node;
+		});
+}
+
+template<typename List>
+double runList(List values, std::size_t n)
+{
+	return measure([&]
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				values.push_back(i);
+				values.pop_back();
+			}
+			doNotOptimize(values);
+		});
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t max_threads = argSize(argc, argv, std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+	const std::size_t n = argSize(argc, argv, 1000000, 2);
+
+	char name[64];
+	reportOps("1 threads, treiber, immediate delete", runPairs<Reclaim::Immediate>(1, n), 2 * n);
+	for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		std::snprintf(name, sizeof(name), "%zu threads, treiber, delete after run", threads);
+		reportOps(name, runPairs<Reclaim::AfterRun>(threads, n), 2 * threads * n);
+		std::snprintf(name, sizeof(name), "%zu threads, treiber, epoch retire", threads);
+		reportOps(name, runPairs<Reclaim::Epoch>(threads, n), 2 * threads * n);
+	}
+
+	reportOps("list push_back + pop_back, std::allocator", runList(list<std::uint64_t>(), n), 2 * n);
+	{
+		epoch_domain domain;
+		epoch_participant participant(domain);
+		reportOps("list push_back + pop_back, deferred_allocator",
+			runList(list<std::uint64_t, deferred_allocator<std::uint64_t>>(deferred_allocator<std::uint64_t>(domain)), n), 2 * n);
+	}
+	return 0;
+}
@@ -0,0 +1,44 @@
+﻿#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+#include "../NamePool.hpp"
+
+/*
+*  Память на запись и время загрузки: readPersonsInterned против readPersons на скошенных данных
+*  (до 100k фамилий, по 2000 имен и отчеств). Память - прирост пикового RSS, поэтому интернированная
+*  загрузка идет первой. Аргумент - число записей (по умолчанию 4M).
+*/
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 4000000);
+	const std::string file_name = "interning_bench.txt";
+	const std::size_t bytes = writePersonFile(file_name, records);
+	PersonKeeper& keeper = PersonKeeper::instance();
+
+	std::size_t before = peakRssKb();
+	auto start = std::chrono::steady_clock::now();
+	{
+		NamePool pool;
+		stack<InternedPerson> persons = keeper.readPersonsInterned(file_name, pool);
+		reportBytes("readPersonsInterned", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+			bytes, records);
+		std::printf("%-48s %10zu names\n", "distinct names in pool", pool.size());
+	}
+	std::size_t interned = peakRssKb();
+	std::printf("%-48s %10.1f B/record\n", "memory, interned", (interned - before) * 1024.0 / static_cast<double>(records));
+
+	start = std::chrono::steady_clock::now();
+	{
+		stack<Person> persons = keeper.readPersons(file_name);
+		reportBytes("readPersons(file_name)", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+			bytes, records);
+	}
+	std::printf("%-48s %10.1f B/record\n", "memory, stack<Person>", (peakRssKb() - before) * 1024.0 / static_cast<double>(records));
+
+	std::remove(file_name.c_str());
+	return 0;
+}
@@ -0,0 +1,84 @@
+﻿#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+
+#include "bench.hpp"
+#include "../list.hpp"
+#include "../stack.hpp"
+
+/*
+*  Перенос всех элементов одного контейнера в другой: list::append и stack::append перевязкой узлов
+*  против поэлементного переноса. Время - на весь перенос, заполнение в замер не входит.
+*  В target заранее лежит один элемент, чтобы перенос не сводился к перемещению контейнера целиком.
+*  Аргумент - число элементов (по умолчанию 1M).
+*/
+
+
+/* Лучшее время move_all(source, target): в source n элементов, в target один */
+template<typename Container, typename Fill, typename MoveAll>
+double measureTransfer(std::size_t n, Fill fill, MoveAll move_all)
+{
+	double best = 0;
+	for (int run = 0; run < bench_runs; ++run)
+	{
+		Container source, target;
+		fill(source, n);
+		fill(target, 1);
+		auto start = std::chrono::steady_clock::now();
+		move_all(source, target);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		doNotOptimize(target.size());
+		if (run == 0 || seconds < best)
+			best = seconds;
+	}
+	return best;
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t n = argSize(argc, argv, 1000000);
+	char name[64];
+	auto report = [&](const char* what, double seconds)
+	{
+		std::snprintf(name, sizeof(name), "%s, %zu elements", what, n);
+		std::printf("%-48s %14.3f us\n", name, seconds * 1e6);
+	};
+
+	using values = list<std::uint64_t>;
+	auto fill_list = [](values& source, std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			source.push_back(i);
+	};
+	report("list::append", measureTransfer<values>(n, fill_list, [](values& source, values& target)
+		{
+			target.append(std::move(source));
+		}));
+	report("list, element-wise", measureTransfer<values>(n, fill_list, [](values& source, values& target)
+		{
+			while (!source.empty())
+			{
+				target.push_back(std::move(source.front()));
+				source.pop_front();
+			}
+		}));
+
+	using list_stack = stack<std::uint64_t, values>;
+	using deque_stack = stack<std::uint64_t>;
+	auto fill_stack = [](auto& source, std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			source.push(i);
+	};
+	report("stack<list>::append", measureTransfer<list_stack>(n, fill_stack, [](list_stack& source, list_stack& target)
+		{
+			target.append(std::move(source));
+		}));
+	report("stack<deque>::append, element-wise", measureTransfer<deque_stack>(n, fill_stack, [](deque_stack& source, deque_stack& target)
+		{
+			target.append(std::move(source));
+		}));
+	return 0;
+}
@@ -0,0 +1,36 @@
+﻿#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+
+/*
+*  Масштабирование параллельного readPersons(file_name, threads) на 1..N потоках.
+*  Аргументы: число записей (по умолчанию 4M, для многогигабайтного файла - 100M и больше)
+*  и максимальное число потоков (по умолчанию по числу ядер).
+*/
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 4000000);
+	const std::size_t max_threads = std::max<std::size_t>(argSize(argc, argv, std::thread::hardware_concurrency(), 2), 1);
+	const std::string file_name = "parallel_read_bench.txt";
+	const std::size_t bytes = writePersonFile(file_name, records);
+	PersonKeeper& keeper = PersonKeeper::instance();
+
+	double sequential = measure([&] { doNotOptimize(keeper.readPersons(file_name).size()); });
+	reportBytes("readPersons(file_name)", sequential, bytes, records);
+
+	char name[64];
+	for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		double parallel = measure([&] { doNotOptimize(keeper.readPersons(file_name, threads).size()); });
+		std::snprintf(name, sizeof(name), "readPersons(file_name, %zu)", threads);
+		reportBytes(name, parallel, bytes, records);
+	}
+
+	std::remove(file_name.c_str());
+	return 0;
+}
@@ -0,0 +1,46 @@
+﻿#include <cstddef>
+#include <memory>
+
+#include "bench.hpp"
+#include "../list.hpp"
+#include "../pool_allocator.hpp"
+
+/*
+*  Оборот узлов list: pool_allocator против std::allocator.
+*  fill/drain - положить n элементов и снять все; churn - скользящее окно, на каждый push один pop.
+*  Аргумент - число элементов (по умолчанию 1M).
+*/
+template<typename Alloc>
+void run(const char* fill_name, const char* churn_name, std::size_t n)
+{
+	list<std::size_t, Alloc> values;
+	double fill = measure([&]
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				values.push_back(i);
+			while (!values.empty())
+				values.pop_back();
+		});
+	reportOps(fill_name, fill, n);
+
+	for (std::size_t i = 0; i < 1024; ++i)
+		values.push_back(i);
+	double churn = measure([&]
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				values.push_back(i);
+				values.pop_front();
+			}
+		});
+	reportOps(churn_name, churn, n);
+	doNotOptimize(values.size());
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t n = argSize(argc, argv, 1000000);
+	run<std::allocator<std::size_t>>("fill/drain, std::allocator", "churn, std::allocator", n);
+	run<pool_allocator<std::size_t>>("fill/drain, pool_allocator", "churn, pool_allocator", n);
+	return 0;
+}
@@ -0,0 +1,32 @@
+﻿#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+
+/*
+*  Чтение текстового файла людей: отображение в память против std::fstream + getline.
+*  Аргумент - число записей (по умолчанию 2M).
+*/
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 2000000);
+	const std::string file_name = "read_bench.txt";
+	const std::size_t bytes = writePersonFile(file_name, records);
+	PersonKeeper& keeper = PersonKeeper::instance();
+
+	double stream = measure([&]
+		{
+			std::fstream file(file_name, std::ios::in);
+			doNotOptimize(keeper.readPersons(file).size());
+		});
+	reportBytes("readPersons(std::fstream&)", stream, bytes, records);
+
+	double mapped = measure([&] { doNotOptimize(keeper.readPersons(file_name).size()); });
+	reportBytes("readPersons(file_name), mmap", mapped, bytes, records);
+
+	std::remove(file_name.c_str());
+	return 0;
+}
@@ -0,0 +1,50 @@
+﻿#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+
+#include "bench.hpp"
+#include "../stack.hpp"
+#include "../list.hpp"
+#include "../small_stack.hpp"
+
+/*
+*  Короткоживущие стеки: создать, положить k элементов, снять все, уничтожить.
+*  small_stack<.., 32> против stack на std::deque и на list; k = 40 уже не помещается во встроенный буфер.
+*  Аргумент - число циклов (по умолчанию 1M).
+*/
+template<typename Stack>
+void run(const char* name, std::size_t cycles, std::size_t k)
+{
+	double seconds = measure([&]
+		{
+			for (std::size_t cycle = 0; cycle < cycles; ++cycle)
+			{
+				Stack values;
+				for (std::size_t i = 0; i < k; ++i)
+					values.push(cycle + i);
+				std::uint64_t sum = 0;
+				while (!values.empty())
+				{
+					sum += values.top();
+					values.pop();
+				}
+				doNotOptimize(sum);
+			}
+		});
+	char label[64];
+	std::snprintf(label, sizeof(label), "k = %zu, %s", k, name);
+	reportOps(label, seconds, cycles);
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t cycles = argSize(argc, argv, 1000000);
+	for (std::size_t k : { 4, 16, 32, 40 })
+	{
+		run<small_stack<std::uint64_t, 32>>("small_stack<32>", cycles, k);
+		run<stack<std::uint64_t>>("stack on std::deque", cycles, k);
+		run<stack<std::uint64_t, list<std::uint64_t>>>("stack on list", cycles, k);
+	}
+	return 0;
+}
@@ -0,0 +1,46 @@
+﻿#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+
+/*
+*  Пиковая память: потоковый forEachPerson против readPersons, собирающего весь стек.
+*  Пиковый RSS процесса только растет, поэтому потоковое чтение меряется первым.
+*  Аргумент - число записей (по умолчанию 4M).
+*/
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 4000000);
+	const std::string file_name = "streaming_bench.txt";
+	const std::size_t bytes = writePersonFile(file_name, records);
+	PersonKeeper& keeper = PersonKeeper::instance();
+	std::printf("%-48s %10zu KB\n", "peak RSS before loading", peakRssKb());
+
+	/* Агрегат, ради которого читаем: сколько фамилий на букву A */
+	std::size_t matched = 0;
+	auto start = std::chrono::steady_clock::now();
+	{
+		std::fstream file(file_name, std::ios::in);
+		keeper.forEachPerson(file, [&matched](Person&& person) { matched += person.getLastName()[0] == 'A'; });
+	}
+	reportBytes("forEachPerson", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), bytes, records);
+	std::printf("%-48s %10zu KB\n", "peak RSS after forEachPerson", peakRssKb());
+
+	start = std::chrono::steady_clock::now();
+	{
+		std::fstream file(file_name, std::ios::in);
+		stack<Person> persons = keeper.readPersons(file);
+		for (const Person& person : persons.getContainer())
+			matched += person.getLastName()[0] == 'A';
+	}
+	reportBytes("readPersons(std::fstream&)", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), bytes, records);
+	std::printf("%-48s %10zu KB\n", "peak RSS after readPersons", peakRssKb());
+
+	doNotOptimize(matched);
+	std::remove(file_name.c_str());
+	return 0;
+}
@@ -0,0 +1,80 @@
+﻿#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+
+#include "bench.hpp"
+#include "../stack.hpp"
+#include "../EStackEmpty.hpp"
+
+/*
+*  Циклы, опустошающие стек: конец по исключению EStackEmpty против try_pop и проверки empty().
+*  Стек из k элементов опустошается cycles раз; на каждый цикл приходится одно исключение.
+*  Аргумент - число циклов (по умолчанию 100k).
+*/
+int main(int argc, char** argv)
+{
+	const std::size_t cycles = argSize(argc, argv, 100000);
+	char name[64];
+	for (std::size_t k : { 1, 16, 256 })
+	{
+		stack<std::uint64_t> values;
+		auto fill = [&]
+		{
+			for (std::size_t i = 0; i < k; ++i)
+				values.push(i);
+		};
+
+		double by_exception = measure([&]
+			{
+				std::uint64_t sum = 0;
+				for (std::size_t cycle = 0; cycle < cycles; ++cycle)
+				{
+					fill();
+					try
+					{
+						for (;;)
+						{
+							sum += values.top();
+							values.pop();
+						}
+					}
+					catch (const EStackEmpty&)
+					{
+					}
+				}
+				doNotOptimize(sum);
+			});
+		std::snprintf(name, sizeof(name), "k = %zu, top/pop until EStackEmpty", k);
+		reportOps(name, by_exception, cycles);
+
+		double by_optional = measure([&]
+			{
+				std::uint64_t sum = 0;
+				for (std::size_t cycle = 0; cycle < cycles; ++cycle)
+				{
+					fill();
+					while (std::optional<std::uint64_t> value = values.try_pop())
+						sum += *value;
+				}
+				doNotOptimize(sum);
+			});
+		std::snprintf(name, sizeof(name), "k = %zu, try_pop() -> optional", k);
+		reportOps(name, by_optional, cycles);
+
+		double by_reference = measure([&]
+			{
+				std::uint64_t sum = 0, value = 0;
+				for (std::size_t cycle = 0; cycle < cycles; ++cycle)
+				{
+					fill();
+					while (values.try_pop(value))
+						sum += value;
+				}
+				doNotOptimize(sum);
+			});
+		std::snprintf(name, sizeof(name), "k = %zu, try_pop(value)", k);
+		reportOps(name, by_reference, cycles);
+	}
+	return 0;
+}
@@ -0,0 +1,48 @@
+﻿#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "bench.hpp"
+#include "../stack.hpp"
+#include "../list.hpp"
+#include "../unrolled_list.hpp"
+
+/*
+*  stack<std::uint64_t> поверх unrolled_list, list и std::deque:
+*  push/pop - положить n элементов и снять все, iterate - сумма по getContainer().
+*  Аргумент - число элементов (по умолчанию 1M).
+*/
+template<typename Container>
+void run(const char* push_pop_name, const char* iterate_name, std::size_t n)
+{
+	stack<std::uint64_t, Container> values;
+	double push_pop = measure([&]
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				values.push(i);
+			while (!values.empty())
+				values.pop();
+		});
+	reportOps(push_pop_name, push_pop, 2 * n);
+
+	for (std::size_t i = 0; i < n; ++i)
+		values.push(i);
+	std::uint64_t sum = 0;
+	double iterate = measure([&]
+		{
+			for (std::uint64_t value : values.getContainer())
+				sum += value;
+		});
+	reportOps(iterate_name, iterate, n);
+	doNotOptimize(sum);
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t n = argSize(argc, argv, 1000000);
+	run<unrolled_list<std::uint64_t>>("push/pop, unrolled_list<16>", "iterate, unrolled_list<16>", n);
+	run<unrolled_list<std::uint64_t, 64>>("push/pop, unrolled_list<64>", "iterate, unrolled_list<64>", n);
+	run<list<std::uint64_t>>("push/pop, list", "iterate, list", n);
+	run<std::deque<std::uint64_t>>("push/pop, std::deque", "iterate, std::deque", n);
+	return 0;
+}
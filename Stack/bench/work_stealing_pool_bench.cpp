@@ -0,0 +1,89 @@
+﻿#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "../work_stealing_pool.hpp"
+
+/*
+*  Рекурсивный обход двоичного дерева на work_stealing_pool с 1..N рабочими потоками.
+*  Дерево неявное: задача - номер узла, узел порождает двух детей, пока не достигнута глубина.
+*  В каждом узле немного счета, чтобы задача не была пустой. Для сравнения - тот же обход рекурсией в одном потоке.
+*  Аргументы: глубина дерева (по умолчанию 20), максимум потоков (по умолчанию по числу ядер).
+*/
+
+
+/* Работа в узле: несколько раундов перемешивания номера */
+inline std::uint64_t visit(std::uint64_t node)
+{
+	std::uint64_t hash = node;
+	for (int i = 0; i < 64; ++i)
+		hash = (hash ^ (hash >> 31)) * 0x9E3779B97F4A7C15ull;
+	return hash;
+}
+
+std::uint64_t traverse(std::uint64_t node, std::uint64_t depth, std::uint64_t max_depth)
+{
+	std::uint64_t hash = visit(node);
+	if (depth < max_depth)
+		hash += traverse(2 * node, depth + 1, max_depth) + traverse(2 * node + 1, depth + 1, max_depth);
+	return hash;
+}
+
+/* Счетчик узлов и хэш одного рабочего, на своей строке кэша */
+struct alignas(64) Tally final
+{
+	std::uint64_t nodes = 0;
+	std::uint64_t hash = 0;
+};
+
+double runPool(std::size_t workers, std::uint64_t max_depth, std::uint64_t expected)
+{
+	return measure([&]
+		{
+			work_stealing_pool<std::uint64_t> pool(workers);
+			std::vector<Tally> tallies(workers);
+			pool.push(0, 1); /* Корень; номер узла на глубине d лежит в [2^d, 2^(d+1)) */
+			pool.run([&](std::size_t worker, std::uint64_t node)
+				{
+					tallies[worker].nodes++;
+					tallies[worker].hash += visit(node);
+					if ((node >> max_depth) == 0) /* Глубина узла меньше max_depth */
+					{
+						pool.push(worker, 2 * node);
+						pool.push(worker, 2 * node + 1);
+					}
+				});
+
+			std::uint64_t nodes = 0, hash = 0;
+			for (const Tally& tally : tallies)
+			{
+				nodes += tally.nodes;
+				hash += tally.hash;
+			}
+			if (nodes != (std::uint64_t(2) << max_depth) - 1 || hash != expected)
+				throw std::runtime_error("Tree traversal lost or repeated nodes!\n");
+		});
+}
+
+int main(int argc, char** argv)
+{
+	const std::uint64_t max_depth = std::min<std::uint64_t>(argSize(argc, argv, 20), 40);
+	const std::size_t max_workers = argSize(argc, argv, std::max<std::size_t>(std::thread::hardware_concurrency(), 1), 2);
+	const std::size_t nodes = (std::size_t(2) << max_depth) - 1;
+
+	std::uint64_t expected = 0;
+	reportOps("sequential recursion", measure([&] { expected = traverse(1, 0, max_depth); }), nodes);
+
+	char name[64];
+	for (std::size_t workers = 1; workers <= max_workers; workers *= 2)
+	{
+		std::snprintf(name, sizeof(name), "work_stealing_pool, %zu workers", workers);
+		reportOps(name, runPool(workers, max_depth, expected), nodes);
+	}
+	return 0;
+}
@@ -0,0 +1,44 @@
+﻿#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "bench.hpp"
+#include "../PersonKeeper.hpp"
+
+/*
+*  Запись стека людей в текстовый файл: прежний построчный вывод (копия Person и временная строка на запись)
+*  против буферизованного writePersons(std::fstream&) и writePersons(file_name) с записью в дескриптор.
+*  Аргумент - число записей (по умолчанию 10M).
+*/
+int main(int argc, char** argv)
+{
+	const std::size_t records = argSize(argc, argv, 10000000);
+	const std::string source_name = "write_bench_source.txt";
+	const std::string file_name = "write_bench.txt";
+	const std::size_t bytes = writePersonFile(source_name, records);
+	PersonKeeper& keeper = PersonKeeper::instance();
+	const stack<Person> persons = keeper.readPersons(source_name);
+	std::remove(source_name.c_str());
+
+	double line_by_line = measure([&]
+		{
+			std::fstream file(file_name, std::ios::out | std::ios::trunc);
+			for (auto it : persons.getContainer()) /* Как было до буферизации */
+				file << it.getLastName() + ' ' + it.getFirstName() + ' ' + it.getPatronymic() + '\n';
+		});
+	reportBytes("line by line (previous writePersons)", line_by_line, bytes, records);
+
+	double buffered = measure([&]
+		{
+			std::fstream file(file_name, std::ios::out | std::ios::trunc);
+			keeper.writePersons(persons, file);
+		});
+	reportBytes("writePersons(std::fstream&)", buffered, bytes, records);
+
+	double gathered = measure([&] { keeper.writePersons(persons, file_name); });
+	reportBytes("writePersons(file_name)", gathered, bytes, records);
+
+	std::remove(file_name.c_str());
+	return 0;
+}
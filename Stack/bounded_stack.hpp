@@ -0,0 +1,338 @@
+﻿#ifndef _bounded_stack_hpp
+#define _bounded_stack_hpp
+
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+/*
+*  Хранилище bounded_stack. Для тривиальных типов - обычный массив, поэтому весь контейнер
+*  остается литеральным типом и работает в constexpr. Массив не обнуляется, элемент пишется при вставке;
+*  строго по стандарту constexpr без инициализации всех членов допустим с C++20. Для остальных - выровненная сырая память,
+*  элементы конструируются лениво и конструктор по умолчанию у типа не требуется.
+*/
+template<typename Type, std::size_t Capacity, bool Trivial = std::is_trivial_v<Type>>
+class bounded_storage;
+
+template<typename Type, std::size_t Capacity>
+class bounded_storage<Type, Capacity, true> final
+{
+public:
+	constexpr Type* data() noexcept { return elements; }
+	constexpr const Type* data() const noexcept { return elements; }
+
+	Type elements[Capacity];
+	std::size_t count = 0;
+};
+
+template<typename Type, std::size_t Capacity>
+class bounded_storage<Type, Capacity, false> final
+{
+public:
+	/* Конструкторы и деструктор */
+	bounded_storage() = default;
+	bounded_storage(const bounded_storage& oth);
+	bounded_storage(bounded_storage&& oth) noexcept(std::is_nothrow_move_constructible_v<Type>);
+	~bounded_storage();
+
+	/* Операторы */
+	bounded_storage& operator=(const bounded_storage& oth) &;
+	bounded_storage& operator=(bounded_storage&& oth) & noexcept(std::is_nothrow_move_constructible_v<Type>);
+
+	Type* data() noexcept { return std::launder(reinterpret_cast<Type*>(buffer)); }
+	const Type* data() const noexcept { return std::launder(reinterpret_cast<const Type*>(buffer)); }
+	void clear() noexcept; /* Уничтожает все элементы */
+	template<typename Source>
+	void fill_from(Source&& oth); /* Копирует или перемещает элементы oth в пустое хранилище */
+
+	alignas(Type) unsigned char buffer[sizeof(Type) * Capacity];
+	std::size_t count = 0;
+};
+
+
+/*
+*  Однопоточный контейнер фиксированной вместимости, никогда не обращающийся к куче.
+*  Вместимость задается на этапе компиляции, элементы лежат прямо в объекте.
+*  При переполнении push_back/emplace_back кидают std::length_error,
+*  а try_push/try_emplace возвращают false, ничего не создавая.
+*  Реализованы методы, нужные stack, поэтому используется как его Container.
+*  Для тривиальных типов все методы доступны в constexpr.
+*/
+template<typename Type, std::size_t Capacity>
+class bounded_stack final
+{
+	static_assert(Capacity > 0, "bounded_stack requires non-zero capacity");
+public:
+	/* Типы */
+	using value_type = Type;
+	using pointer = Type*;
+	using reference = Type&;
+	using iterator = Type*;
+	using const_iterator = const Type*;
+
+	/* Методы */
+	constexpr Type& back(); /* Возвращает ссылку на верхний элемент */
+	constexpr const Type& back() const; /* Возвращает константную ссылку на верхний элемент */
+
+	constexpr bool empty() const noexcept; /* Если контейнер пустой, возвращает true, иначе false */
+	constexpr bool full() const noexcept; /* Если места больше нет, возвращает true, иначе false */
+	constexpr std::size_t size() const noexcept; /* Возвращает размер контейнера */
+	static constexpr std::size_t capacity() noexcept; /* Возвращает вместимость */
+	constexpr void clear() noexcept; /* Чистит контейнер */
+
+	constexpr void push_back(const Type& value); /* Кладет lvalue значение в конец; если места нет - кидает исключение */
+	constexpr void push_back(Type&& value); /* Кладет rvalue* значение в конец; если места нет - кидает исключение */
+	template<typename... Args>
+	constexpr void emplace_back(Args&&... args); /* Создает в конце элемент от входящих аргументов; если места нет - кидает исключение */
+
+	constexpr bool try_push(const Type& value); /* Кладет lvalue значение в конец; false, если места нет */
+	constexpr bool try_push(Type&& value); /* Кладет rvalue* значение в конец; false, если места нет */
+	template<typename... Args>
+	constexpr bool try_emplace(Args&&... args); /* Создает в конце элемент от входящих аргументов; false, если места нет */
+
+	constexpr void pop_back() noexcept; /* Удаляет элемент из конца */
+
+	/* Методы для работы с итераторами */
+	constexpr iterator begin() noexcept;
+	constexpr const_iterator begin() const noexcept;
+	constexpr iterator end() noexcept;
+	constexpr const_iterator end() const noexcept;
+	constexpr const_iterator cbegin() const noexcept;
+	constexpr const_iterator cend() const noexcept;
+private:
+	static constexpr bool trivial = std::is_trivial_v<Type>;
+
+	template<typename... Args>
+	constexpr void construct_back(Args&&... args); /* Создает элемент на свободном месте, место должно быть */
+
+	/* Поля */
+	bounded_storage<Type, Capacity> storage{};
+};
+
+
+template<typename Type, std::size_t Capacity>
+bounded_storage<Type, Capacity, false>::bounded_storage(const bounded_storage& oth)
+{
+	fill_from(oth);
+}
+
+template<typename Type, std::size_t Capacity>
+bounded_storage<Type, Capacity, false>::bounded_storage(bounded_storage&& oth) noexcept(std::is_nothrow_move_constructible_v<Type>)
+{
+	fill_from(std::move(oth));
+}
+
+template<typename Type, std::size_t Capacity>
+bounded_storage<Type, Capacity, false>::~bounded_storage()
+{
+	clear();
+}
+
+template<typename Type, std::size_t Capacity>
+bounded_storage<Type, Capacity, false>& bounded_storage<Type, Capacity, false>::operator=(const bounded_storage& oth) &
+{
+	if (this == std::addressof(oth))
+		return *this;
+
+	clear();
+	fill_from(oth);
+	return *this;
+}
+
+template<typename Type, std::size_t Capacity>
+bounded_storage<Type, Capacity, false>& bounded_storage<Type, Capacity, false>::operator=(bounded_storage&& oth) & noexcept(std::is_nothrow_move_constructible_v<Type>)
+{
+	if (this == std::addressof(oth))
+		return *this;
+
+	clear();
+	fill_from(std::move(oth));
+	return *this;
+}
+
+template<typename Type, std::size_t Capacity>
+void bounded_storage<Type, Capacity, false>::clear() noexcept
+{
+	for (; count; --count)
+		std::destroy_at(data() + count - 1);
+}
+
+template<typename Type, std::size_t Capacity>
+template<typename Source>
+void bounded_storage<Type, Capacity, false>::fill_from(Source&& oth)
+{
+	try
+	{
+		for (; count < oth.count; ++count)
+			if constexpr (std::is_lvalue_reference_v<Source>)
+				::new (static_cast<void*>(data() + count)) Type(oth.data()[count]);
+			else /* Для rvalue элементы перемещаются */
+				::new (static_cast<void*>(data() + count)) Type(std::move(oth.data()[count]));
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+}
+
+
+template<typename Type, std::size_t Capacity>
+constexpr Type& bounded_stack<Type, Capacity>::back()
+{
+	if (storage.count)
+		return storage.data()[storage.count - 1];
+	else
+		throw std::runtime_error("Stack is empty!\n"); /* Если запрашиваем элемент из пустого контейнера */
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr const Type& bounded_stack<Type, Capacity>::back() const
+{
+	if (storage.count)
+		return storage.data()[storage.count - 1];
+	else
+		throw std::runtime_error("Stack is empty!\n"); /* Если запрашиваем элемент из пустого контейнера */
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr bool bounded_stack<Type, Capacity>::empty() const noexcept
+{
+	return storage.count == 0;
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr bool bounded_stack<Type, Capacity>::full() const noexcept
+{
+	return storage.count == Capacity;
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr std::size_t bounded_stack<Type, Capacity>::size() const noexcept
+{
+	return storage.count;
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr std::size_t bounded_stack<Type, Capacity>::capacity() noexcept
+{
+	return Capacity;
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr void bounded_stack<Type, Capacity>::clear() noexcept
+{
+	if constexpr (trivial)
+		storage.count = 0;
+	else
+		storage.clear();
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr void bounded_stack<Type, Capacity>::push_back(const Type& value)
+{
+	emplace_back(value);
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr void bounded_stack<Type, Capacity>::push_back(Type&& value)
+{
+	emplace_back(std::move(value));
+}
+
+template<typename Type, std::size_t Capacity>
+template<typename... Args>
+constexpr void bounded_stack<Type, Capacity>::emplace_back(Args&&... args)
+{
+	if (full())
+		throw std::length_error("Stack is full!\n"); /* Если места больше нет */
+
+	construct_back(std::forward<Args>(args)...);
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr bool bounded_stack<Type, Capacity>::try_push(const Type& value)
+{
+	return try_emplace(value);
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr bool bounded_stack<Type, Capacity>::try_push(Type&& value)
+{
+	return try_emplace(std::move(value));
+}
+
+template<typename Type, std::size_t Capacity>
+template<typename... Args>
+constexpr bool bounded_stack<Type, Capacity>::try_emplace(Args&&... args)
+{
+	if (full())
+		return false;
+
+	construct_back(std::forward<Args>(args)...);
+	return true;
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr void bounded_stack<Type, Capacity>::pop_back() noexcept
+{
+	if (empty())
+		return;
+
+	--storage.count;
+	if constexpr (!trivial)
+		std::destroy_at(storage.data() + storage.count);
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr typename bounded_stack<Type, Capacity>::iterator bounded_stack<Type, Capacity>::begin() noexcept
+{
+	return storage.data();
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr typename bounded_stack<Type, Capacity>::const_iterator bounded_stack<Type, Capacity>::begin() const noexcept
+{
+	return storage.data();
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr typename bounded_stack<Type, Capacity>::iterator bounded_stack<Type, Capacity>::end() noexcept
+{
+	return storage.data() + storage.count;
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr typename bounded_stack<Type, Capacity>::const_iterator bounded_stack<Type, Capacity>::end() const noexcept
+{
+	return storage.data() + storage.count;
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr typename bounded_stack<Type, Capacity>::const_iterator bounded_stack<Type, Capacity>::cbegin() const noexcept
+{
+	return begin();
+}
+
+template<typename Type, std::size_t Capacity>
+constexpr typename bounded_stack<Type, Capacity>::const_iterator bounded_stack<Type, Capacity>::cend() const noexcept
+{
+	return end();
+}
+
+template<typename Type, std::size_t Capacity>
+template<typename... Args>
+constexpr void bounded_stack<Type, Capacity>::construct_back(Args&&... args)
+{
+	if constexpr (trivial) /* Тривиальный тип просто присваиваем, это допустимо в constexpr */
+		storage.elements[storage.count] = Type(std::forward<Args>(args)...);
+	else
+		::new (static_cast<void*>(storage.data() + storage.count)) Type(std::forward<Args>(args)...);
+	++storage.count;
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,348 @@
+﻿#ifndef _concurrent_stack_hpp
+#define _concurrent_stack_hpp
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*
+*  Многопоточный lock-free стек (стек Трайбера).
+*  Узлы выделяются блоками, блок k вмещает first_block << k узлов, и узел однозначно задается номером (с единицы).
+*  Вершина хранится как 64-битное слово: младшие 32 бита - номер узла (0 - пусто), старшие 32 - счетчик версий.
+*  Каждая успешная CAS увеличивает счетчик, поэтому "ABA" (узел сняли и вернули между load и CAS) не проходит,
+*  пока между load и CAS одного потока не случилось ровно 2^32 успешных CAS той же вершины.
+*  Указатели в слово не упаковываются, так что раскладка адресов платформы не важна; узлов не больше ~2^32.
+*  Снятые узлы не возвращаются аллокатору, а складываются в собственный lock-free список свободных узлов
+*  и переиспользуются, поэтому чтение next у узла, который уже сняли другим потоком, безопасно.
+*  Вся память освобождается в деструкторе, который должен вызываться, когда стеком никто не пользуется.
+*  Аллокатор должен быть потокобезопасным (std::allocator подходит, pool_allocator - нет).
+*  Конструктор по умолчанию у типа не требуется.
+*/
+template<typename Type, typename Alloc, std::size_t Slots>
+class elimination_stack;
+
+template<typename Type, typename Alloc = std::allocator<Type>>
+class concurrent_stack final
+{
+	/* Стек с элиминацией использует узлы и одиночные попытки CAS этого стека */
+	template<typename, typename, std::size_t>
+	friend class elimination_stack;
+public:
+	/* Типы */
+	using value_type = Type;
+	using pointer = Type*;
+	using reference = Type&;
+
+	/* Конструкторы и деструктор */
+	explicit concurrent_stack(const Alloc& alloc = Alloc());
+	concurrent_stack(const concurrent_stack& oth) = delete;
+	concurrent_stack(concurrent_stack&& oth) = delete;
+	~concurrent_stack();
+
+	/* Операторы */
+	concurrent_stack& operator=(const concurrent_stack& oth) = delete;
+	concurrent_stack& operator=(concurrent_stack&& oth) = delete;
+	/* Методы */
+	bool empty() const noexcept; /* Снимок: к моменту возврата стек мог измениться */
+
+	void push(const Type& value); /* Кладет lvalue значение в вершину стека */
+	void push(Type&& value); /* Кладет rvalue* значение в вершину стека */
+
+	template<typename... Args>
+	void emplace(Args&&... args); /* Создает в вершине стека элемент от входящих аргументов */
+
+	bool try_pop(Type& value); /* Перемещает верхний элемент в value и удаляет его; false, если стек пуст */
+private:
+	/* Узел стека: значение конструируется только пока узел лежит в стеке */
+	struct Node final
+	{
+		alignas(Type) unsigned char storage[sizeof(Type)];
+		std::atomic<std::uint32_t> next{ 0 }; /* Номер следующего узла; атомарный, т.к. его может читать поток, проигравший CAS */
+		std::uint32_t number = 0; /* Номер узла, задается при выделении блока */
+
+		Type* value() noexcept
+		{
+			return std::launder(reinterpret_cast<Type*>(storage));
+		}
+	};
+
+	using RebindAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+	using AllocTraits = typename std::allocator_traits<RebindAlloc>;
+
+	/* Упаковка номера узла и счетчика версий в одно слово */
+	static constexpr std::uint64_t number_mask = 0xFFFFFFFFull;
+	static constexpr std::size_t first_block = 64; /* Узлов в нулевом блоке */
+	static constexpr std::size_t max_blocks = 26; /* first_block * (2^26 - 1) номеров почти покрывают 32 бита */
+	static constexpr std::uint64_t max_nodes = first_block * ((std::uint64_t(1) << max_blocks) - 1);
+
+	static std::uint64_t pack(Node* node, std::uint64_t tag) noexcept;
+	Node* unpack(std::uint64_t word) const noexcept;
+	static std::uint64_t next_tag(std::uint64_t word) noexcept;
+	static std::size_t block_of(std::uint64_t position) noexcept; /* Номер блока позиции (номер узла - 1) */
+	static std::size_t block_size(std::size_t block) noexcept;
+	static std::uint64_t block_start(std::size_t block) noexcept; /* Позиция первого узла блока */
+
+	void push_node(std::atomic<std::uint64_t>& top, Node* node) noexcept; /* Кладет узел в стек Трайбера */
+	Node* pop_node(std::atomic<std::uint64_t>& top) noexcept; /* Снимает узел со стека Трайбера или nullptr */
+	bool try_push_node(Node* node) noexcept; /* Одна попытка положить узел в вершину; false, если CAS проиграна */
+	Node* try_pop_node(bool& contended) noexcept; /* Одна попытка снять вершину; nullptr и contended, если CAS проиграна */
+	void recycle_node(Node* node) noexcept; /* Уничтожает значение и отдает узел на переиспользование */
+
+	Node* acquire_node(); /* Берет узел из списка свободных или новый номер */
+	Node* install_block(std::size_t block); /* Выделяет блок узлов; если его уже выделил другой поток, возвращает тот */
+
+	/* Поля */
+	std::atomic<std::uint64_t> head{ 0 }; /* Вершина стека */
+	std::atomic<std::uint64_t> free_list{ 0 }; /* Свободные узлы для переиспользования */
+	std::atomic<std::uint64_t> numbers{ 0 }; /* Сколько номеров узлов роздано */
+	std::atomic<Node*> blocks[max_blocks]{}; /* Блок появляется раньше, чем номер его узла попадет в любое слово */
+	RebindAlloc rebind_alloc{};
+};
+
+
+template<typename Type, typename Alloc>
+concurrent_stack<Type, Alloc>::concurrent_stack(const Alloc& alloc)
+	: rebind_alloc(alloc)
+{}
+
+template<typename Type, typename Alloc>
+concurrent_stack<Type, Alloc>::~concurrent_stack()
+{
+	for (Node* temp = unpack(head.load(std::memory_order_relaxed)); temp; temp = unpack(temp->next.load(std::memory_order_relaxed)))
+		std::destroy_at(temp->value());
+
+	/* Память узлов - в блоках, свободные и занятые узлы освобождаются вместе */
+	for (std::size_t block = 0; block < max_blocks; ++block)
+		if (Node* first = blocks[block].load(std::memory_order_relaxed))
+		{
+			for (std::size_t i = 0; i < block_size(block); ++i)
+				AllocTraits::destroy(rebind_alloc, first + i);
+			AllocTraits::deallocate(rebind_alloc, first, block_size(block));
+		}
+}
+
+
+template<typename Type, typename Alloc>
+bool concurrent_stack<Type, Alloc>::empty() const noexcept
+{
+	return (head.load(std::memory_order_acquire) & number_mask) == 0;
+}
+
+template<typename Type, typename Alloc>
+void concurrent_stack<Type, Alloc>::push(const Type& value)
+{
+	emplace(value);
+}
+
+template<typename Type, typename Alloc>
+void concurrent_stack<Type, Alloc>::push(Type&& value)
+{
+	emplace(std::move(value));
+}
+
+template<typename Type, typename Alloc>
+template<typename... Args>
+void concurrent_stack<Type, Alloc>::emplace(Args&&... args)
+{
+	Node* temp = acquire_node();
+
+	try
+	{
+		::new (static_cast<void*>(temp->storage)) Type(std::forward<Args>(args)...);
+	}
+	catch (...)
+	{ /* Узел еще никому не виден - возвращаем его в список свободных */
+		push_node(free_list, temp);
+		throw;
+	}
+
+	push_node(head, temp);
+}
+
+template<typename Type, typename Alloc>
+bool concurrent_stack<Type, Alloc>::try_pop(Type& value)
+{
+	Node* temp = pop_node(head);
+	if (!temp)
+		return false;
+
+	/* Узел теперь принадлежит только нам - забираем значение и отдаем узел на переиспользование */
+	struct recycle final
+	{
+		concurrent_stack* self;
+		Node* node;
+
+		~recycle()
+		{
+			self->recycle_node(node);
+		}
+	} guard{ this, temp };
+
+	value = std::move(*temp->value());
+	return true;
+}
+
+
+template<typename Type, typename Alloc>
+std::uint64_t concurrent_stack<Type, Alloc>::pack(Node* node, std::uint64_t tag) noexcept
+{
+	return (node ? node->number : 0) | (tag << 32);
+}
+
+template<typename Type, typename Alloc>
+typename concurrent_stack<Type, Alloc>::Node* concurrent_stack<Type, Alloc>::unpack(std::uint64_t word) const noexcept
+{
+	const std::uint64_t number = word & number_mask;
+	if (number == 0)
+		return nullptr;
+
+	const std::uint64_t position = number - 1;
+	const std::size_t block = block_of(position);
+	return blocks[block].load(std::memory_order_acquire) + (position - block_start(block));
+}
+
+template<typename Type, typename Alloc>
+std::uint64_t concurrent_stack<Type, Alloc>::next_tag(std::uint64_t word) noexcept
+{
+	return ((word >> 32) + 1) & number_mask;
+}
+
+template<typename Type, typename Alloc>
+std::size_t concurrent_stack<Type, Alloc>::block_of(std::uint64_t position) noexcept
+{
+	/* Блок k начинается с позиции first_block * (2^k - 1), поэтому k = floor(log2(position / first_block + 1)) */
+	const std::uint64_t scaled = position / first_block + 1;
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, scaled);
+	return static_cast<std::size_t>(index);
+#else
+	return static_cast<std::size_t>(63 - __builtin_clzll(scaled));
+#endif
+}
+
+template<typename Type, typename Alloc>
+std::size_t concurrent_stack<Type, Alloc>::block_size(std::size_t block) noexcept
+{
+	return first_block << block;
+}
+
+template<typename Type, typename Alloc>
+std::uint64_t concurrent_stack<Type, Alloc>::block_start(std::size_t block) noexcept
+{
+	return first_block * ((std::uint64_t(1) << block) - 1);
+}
+
+template<typename Type, typename Alloc>
+void concurrent_stack<Type, Alloc>::push_node(std::atomic<std::uint64_t>& top, Node* node) noexcept
+{
+	std::uint64_t old_top = top.load(std::memory_order_relaxed);
+	do
+	{
+		node->next.store(static_cast<std::uint32_t>(old_top & number_mask), std::memory_order_relaxed);
+	} while (!top.compare_exchange_weak(old_top, pack(node, next_tag(old_top)),
+		std::memory_order_release, std::memory_order_relaxed));
+}
+
+template<typename Type, typename Alloc>
+typename concurrent_stack<Type, Alloc>::Node* concurrent_stack<Type, Alloc>::pop_node(std::atomic<std::uint64_t>& top) noexcept
+{
+	std::uint64_t old_top = top.load(std::memory_order_acquire);
+	for (;;)
+	{
+		Node* node = unpack(old_top);
+		if (!node)
+			return nullptr;
+
+		/* Узел мог уже уйти другому потоку, но его память жива, а устаревший next отсеет счетчик версий */
+		const std::uint64_t next = node->next.load(std::memory_order_relaxed);
+		if (top.compare_exchange_weak(old_top, next | (next_tag(old_top) << 32),
+			std::memory_order_acquire, std::memory_order_acquire))
+			return node;
+	}
+}
+
+template<typename Type, typename Alloc>
+bool concurrent_stack<Type, Alloc>::try_push_node(Node* node) noexcept
+{
+	std::uint64_t old_top = head.load(std::memory_order_relaxed);
+	node->next.store(static_cast<std::uint32_t>(old_top & number_mask), std::memory_order_relaxed);
+	return head.compare_exchange_strong(old_top, pack(node, next_tag(old_top)),
+		std::memory_order_release, std::memory_order_relaxed);
+}
+
+template<typename Type, typename Alloc>
+typename concurrent_stack<Type, Alloc>::Node* concurrent_stack<Type, Alloc>::try_pop_node(bool& contended) noexcept
+{
+	std::uint64_t old_top = head.load(std::memory_order_acquire);
+	Node* node = unpack(old_top);
+	contended = false;
+	if (!node)
+		return nullptr;
+
+	const std::uint64_t next = node->next.load(std::memory_order_relaxed);
+	if (head.compare_exchange_strong(old_top, next | (next_tag(old_top) << 32),
+		std::memory_order_acquire, std::memory_order_relaxed))
+		return node;
+
+	contended = true;
+	return nullptr;
+}
+
+template<typename Type, typename Alloc>
+void concurrent_stack<Type, Alloc>::recycle_node(Node* node) noexcept
+{
+	std::destroy_at(node->value());
+	push_node(free_list, node);
+}
+
+template<typename Type, typename Alloc>
+typename concurrent_stack<Type, Alloc>::Node* concurrent_stack<Type, Alloc>::acquire_node()
+{
+	if (Node* temp = pop_node(free_list))
+		return temp;
+
+	const std::uint64_t position = numbers.fetch_add(1, std::memory_order_relaxed);
+	if (position >= max_nodes)
+		throw std::length_error("Concurrent stack node limit reached\n");
+
+	const std::size_t block = block_of(position);
+	Node* first = blocks[block].load(std::memory_order_acquire);
+	if (!first)
+		first = install_block(block);
+	return first + (position - block_start(block));
+}
+
+template<typename Type, typename Alloc>
+typename concurrent_stack<Type, Alloc>::Node* concurrent_stack<Type, Alloc>::install_block(std::size_t block)
+{
+	const std::size_t size = block_size(block);
+	Node* first = AllocTraits::allocate(rebind_alloc, size);
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		AllocTraits::construct(rebind_alloc, first + i);
+		first[i].number = static_cast<std::uint32_t>(block_start(block) + i + 1);
+	}
+
+	Node* expected = nullptr;
+	if (blocks[block].compare_exchange_strong(expected, first, std::memory_order_acq_rel, std::memory_order_acquire))
+		return first;
+
+	/* Блок успел выделить другой поток - берем его, свой отдаем обратно */
+	for (std::size_t i = 0; i < size; ++i)
+		AllocTraits::destroy(rebind_alloc, first + i);
+	AllocTraits::deallocate(rebind_alloc, first, size);
+	return expected;
+}
+
+
+#endif
\ No newline at end of file
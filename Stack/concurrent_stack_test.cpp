@@ -0,0 +1,122 @@
+﻿#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_stack.hpp"
+
+/*
+*  Нагрузочная проверка concurrent_stack: производители кладут различные значения, потребители снимают,
+*  пока не снимут все. Каждое значение должно быть снято ровно один раз, сумма - совпасть.
+*  Второй прогон - смешанный: каждый поток кладет и сразу снимает, узлы постоянно идут через список
+*  свободных, что нагружает защиту от ABA.
+*  Собирать с -fsanitize=thread или -fsanitize=address:
+*      g++ -std=c++17 -O1 -g -pthread -fsanitize=thread concurrent_stack_test.cpp -o concurrent_stack_test
+*  Аргументы: число потоков каждого вида (по умолчанию 4) и значений на поток (по умолчанию 100000).
+*/
+
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+}
+
+static void testProducersConsumers(std::size_t threads, std::size_t per_thread)
+{
+	concurrent_stack<std::uint64_t> values;
+	const std::size_t total = threads * per_thread;
+	std::vector<std::atomic<std::uint32_t>> seen(total); /* Сколько раз снято каждое значение */
+	std::atomic<std::size_t> popped{ 0 };
+	std::atomic<std::uint64_t> sum{ 0 };
+
+	std::vector<std::thread> workers;
+	for (std::size_t t = 0; t < threads; ++t)
+		workers.emplace_back([&, t]
+			{
+				for (std::size_t i = 0; i < per_thread; ++i)
+					values.push(t * per_thread + i);
+			});
+	for (std::size_t t = 0; t < threads; ++t)
+		workers.emplace_back([&]
+			{
+				std::uint64_t local_sum = 0;
+				std::uint64_t value;
+				while (popped.load(std::memory_order_relaxed) < total)
+				{
+					if (!values.try_pop(value))
+					{
+						std::this_thread::yield();
+						continue;
+					}
+					if (value < total)
+						seen[value].fetch_add(1, std::memory_order_relaxed);
+					local_sum += value;
+					popped.fetch_add(1, std::memory_order_relaxed);
+				}
+				sum.fetch_add(local_sum);
+			});
+	for (auto& worker : workers)
+		worker.join();
+
+	bool exactly_once = true;
+	for (auto& count : seen)
+		exactly_once = exactly_once && count.load() == 1;
+	check(exactly_once, "every pushed value is popped exactly once");
+	check(sum.load() == static_cast<std::uint64_t>(total) * (total - 1) / 2, "sum of popped values matches");
+	check(values.empty(), "stack is empty after all pops");
+}
+
+static void testMixed(std::size_t threads, std::size_t per_thread)
+{
+	concurrent_stack<std::uint64_t> values;
+	std::atomic<std::uint64_t> pushed_sum{ 0 };
+	std::atomic<std::uint64_t> popped_sum{ 0 };
+
+	std::vector<std::thread> workers;
+	for (std::size_t t = 0; t < 2 * threads; ++t)
+		workers.emplace_back([&, t]
+			{
+				std::uint64_t pushed = 0, popped = 0, value;
+				for (std::size_t i = 0; i < per_thread; ++i)
+				{
+					value = t * per_thread + i;
+					values.push(value);
+					pushed += value;
+					if (values.try_pop(value)) /* Может снять чужое значение, сумма при этом сходится */
+						popped += value;
+				}
+				pushed_sum.fetch_add(pushed);
+				popped_sum.fetch_add(popped);
+			});
+	for (auto& worker : workers)
+		worker.join();
+
+	std::uint64_t value, rest = 0;
+	while (values.try_pop(value))
+		rest += value;
+	check(popped_sum.load() + rest == pushed_sum.load(), "mixed push/pop loses no values");
+}
+
+
+int main(int argc, char** argv)
+{
+	const std::size_t threads = argc > 1 ? std::stoul(argv[1]) : 4;
+	const std::size_t per_thread = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+	testProducersConsumers(threads, per_thread);
+	testMixed(threads, per_thread);
+
+	if (failures)
+		return 1;
+	std::cout << "concurrent_stack_test: OK\n";
+	return 0;
+}
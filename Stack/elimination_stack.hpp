@@ -0,0 +1,224 @@
+﻿#ifndef _elimination_stack_hpp
+#define _elimination_stack_hpp
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "concurrent_stack.hpp"
+#include "EStackEmpty.hpp"
+
+/*
+*  Многопоточный lock-free стек с массивом элиминации (Hendler, Shavit, Yerushalmi).
+*  Пока вершина свободна, работает как concurrent_stack. Если поток проиграл CAS вершины,
+*  он идет в случайную ячейку массива элиминации: push оставляет там свой узел и немного ждет,
+*  pop забирает оставленный узел. Встретившаяся пара push/pop завершается, не трогая вершину,
+*  поэтому под высокой конкуренцией общая CAS перестает быть узким местом.
+*  top() намеренно отсутствует: без блокировки ссылка на вершину устаревает сразу после возврата,
+*  вместо пары top()/pop() используется pop(), возвращающий значение.
+*/
+template<typename Type, typename Alloc = std::allocator<Type>, std::size_t Slots = 16>
+class elimination_stack final
+{
+	static_assert(Slots > 0, "elimination_stack requires at least one elimination slot");
+public:
+	/* Типы */
+	using value_type = Type;
+	using pointer = Type*;
+	using reference = Type&;
+
+	/* Конструкторы и деструктор */
+	explicit elimination_stack(const Alloc& alloc = Alloc());
+	elimination_stack(const elimination_stack& oth) = delete;
+	elimination_stack(elimination_stack&& oth) = delete;
+	~elimination_stack() = default;
+
+	/* Операторы */
+	elimination_stack& operator=(const elimination_stack& oth) = delete;
+	elimination_stack& operator=(elimination_stack&& oth) = delete;
+	/* Методы */
+	bool empty() const noexcept; /* Снимок: к моменту возврата стек мог измениться */
+
+	void push(const Type& value); /* Кладет lvalue значение в вершину стека */
+	void push(Type&& value); /* Кладет rvalue* значение в вершину стека */
+
+	template<typename... Args>
+	void emplace(Args&&... args); /* Создает в вершине стека элемент от входящих аргументов */
+
+	Type pop(); /* Удаляет верхний элемент и возвращает его; если стек пуст - кидает исключение */
+	bool try_pop(Type& value); /* Перемещает верхний элемент в value и удаляет его; false, если стек пуст */
+private:
+	using base = concurrent_stack<Type, Alloc>;
+	using Node = typename base::Node;
+
+	/* Ячейка массива элиминации на отдельной кэш-линии */
+	struct alignas(64) Slot final
+	{
+		std::atomic<Node*> node{ nullptr };
+	};
+
+	static constexpr std::size_t spin_limit = 128; /* Сколько ждем встречную операцию в ячейке */
+
+	static std::size_t random_slot() noexcept; /* Случайная ячейка, свой генератор у каждого потока */
+	bool eliminate_push(Node* node) noexcept; /* true, если узел забрал встречный pop */
+	Node* eliminate_pop() noexcept; /* Узел от встречного push или nullptr */
+	Node* pop_node(); /* Снимает узел с вершины или через элиминацию; nullptr, если стек пуст */
+
+	/* Поля */
+	base stack;
+	Slot slots[Slots];
+};
+
+
+template<typename Type, typename Alloc, std::size_t Slots>
+elimination_stack<Type, Alloc, Slots>::elimination_stack(const Alloc& alloc)
+	: stack(alloc)
+{}
+
+
+template<typename Type, typename Alloc, std::size_t Slots>
+bool elimination_stack<Type, Alloc, Slots>::empty() const noexcept
+{
+	return stack.empty();
+}
+
+template<typename Type, typename Alloc, std::size_t Slots>
+void elimination_stack<Type, Alloc, Slots>::push(const Type& value)
+{
+	emplace(value);
+}
+
+template<typename Type, typename Alloc, std::size_t Slots>
+void elimination_stack<Type, Alloc, Slots>::push(Type&& value)
+{
+	emplace(std::move(value));
+}
+
+template<typename Type, typename Alloc, std::size_t Slots>
+template<typename... Args>
+void elimination_stack<Type, Alloc, Slots>::emplace(Args&&... args)
+{
+	Node* temp = stack.acquire_node();
+
+	try
+	{
+		::new (static_cast<void*>(temp->storage)) Type(std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		stack.push_node(stack.free_list, temp);
+		throw;
+	}
+
+	while (!stack.try_push_node(temp)) /* Проиграли CAS - пробуем встретиться с pop */
+		if (eliminate_push(temp))
+			return;
+}
+
+template<typename Type, typename Alloc, std::size_t Slots>
+Type elimination_stack<Type, Alloc, Slots>::pop()
+{
+	Node* temp = pop_node();
+	if (!temp)
+		throw EStackEmpty(); /* Если стек пустой - кидаем исключение */
+
+	struct recycle final
+	{
+		base& stack;
+		Node* node;
+
+		~recycle()
+		{
+			stack.recycle_node(node);
+		}
+	} guard{ stack, temp };
+
+	return Type(std::move(*temp->value()));
+}
+
+template<typename Type, typename Alloc, std::size_t Slots>
+bool elimination_stack<Type, Alloc, Slots>::try_pop(Type& value)
+{
+	Node* temp = pop_node();
+	if (!temp)
+		return false;
+
+	struct recycle final
+	{
+		base& stack;
+		Node* node;
+
+		~recycle()
+		{
+			stack.recycle_node(node);
+		}
+	} guard{ stack, temp };
+
+	value = std::move(*temp->value());
+	return true;
+}
+
+
+template<typename Type, typename Alloc, std::size_t Slots>
+std::size_t elimination_stack<Type, Alloc, Slots>::random_slot() noexcept
+{
+	/* xorshift32, засеянный адресом thread_local переменной */
+	thread_local std::uint32_t seed = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&seed) >> 4) | 1;
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed % Slots;
+}
+
+template<typename Type, typename Alloc, std::size_t Slots>
+bool elimination_stack<Type, Alloc, Slots>::eliminate_push(Node* node) noexcept
+{
+	Slot& slot = slots[random_slot()];
+	Node* expected = nullptr;
+	if (!slot.node.compare_exchange_strong(expected, node, std::memory_order_release, std::memory_order_relaxed))
+		return false; /* Ячейка занята другим push */
+
+	for (std::size_t i = 0; i < spin_limit; ++i)
+		if (slot.node.load(std::memory_order_relaxed) != node)
+			return true; /* Узел забрал встречный pop */
+
+	/* Никто не пришел - пытаемся забрать узел обратно; если не вышло, pop успел его взять.
+	*  Узел мог успеть уйти к pop, вернуться в список свободных и снова лечь в ячейку уже с чужим
+	*  значением - тогда мы кладем в стек это значение, а его push считает узел забранным.
+	*  Поэтому забираем с acquire: значение должно быть видно до того, как узел уйдет в вершину */
+	expected = node;
+	return !slot.node.compare_exchange_strong(expected, nullptr, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+template<typename Type, typename Alloc, std::size_t Slots>
+typename elimination_stack<Type, Alloc, Slots>::Node* elimination_stack<Type, Alloc, Slots>::eliminate_pop() noexcept
+{
+	Slot& slot = slots[random_slot()];
+	for (std::size_t i = 0; i < spin_limit; ++i)
+	{
+		Node* node = slot.node.load(std::memory_order_acquire);
+		if (node && slot.node.compare_exchange_strong(node, nullptr, std::memory_order_acquire, std::memory_order_relaxed))
+			return node;
+	}
+	return nullptr;
+}
+
+template<typename Type, typename Alloc, std::size_t Slots>
+typename elimination_stack<Type, Alloc, Slots>::Node* elimination_stack<Type, Alloc, Slots>::pop_node()
+{
+	for (;;)
+	{
+		bool contended = false;
+		if (Node* temp = stack.try_pop_node(contended))
+			return temp;
+		if (!contended) /* Вершина пуста */
+			return nullptr;
+		if (Node* temp = eliminate_pop())
+			return temp;
+	}
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+﻿#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "elimination_stack.hpp"
+
+/*
+*  Нагрузочная проверка elimination_stack, как concurrent_stack_test: каждое значение снимается ровно
+*  один раз, суммы сходятся. Прогоны идут с одной ячейкой элиминации, где встречи и повторное
+*  использование узла в той же ячейке случаются чаще всего, и с ячейками по умолчанию.
+*  Собирать с -fsanitize=thread или -fsanitize=address:
+*      g++ -std=c++17 -O1 -g -pthread -fsanitize=thread elimination_stack_test.cpp -o elimination_stack_test
+*  Аргументы: число потоков каждого вида (по умолчанию 4) и значений на поток (по умолчанию 100000).
+*/
+
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+}
+
+template<std::size_t Slots>
+static void testProducersConsumers(std::size_t threads, std::size_t per_thread)
+{
+	elimination_stack<std::uint64_t, std::allocator<std::uint64_t>, Slots> values;
+	const std::size_t total = threads * per_thread;
+	std::vector<std::atomic<std::uint32_t>> seen(total); /* Сколько раз снято каждое значение */
+	std::atomic<std::size_t> popped{ 0 };
+	std::atomic<std::uint64_t> sum{ 0 };
+
+	std::vector<std::thread> workers;
+	for (std::size_t t = 0; t < threads; ++t)
+		workers.emplace_back([&, t]
+			{
+				for (std::size_t i = 0; i < per_thread; ++i)
+					values.push(t * per_thread + i);
+			});
+	for (std::size_t t = 0; t < threads; ++t)
+		workers.emplace_back([&]
+			{
+				std::uint64_t local_sum = 0;
+				std::uint64_t value;
+				while (popped.load(std::memory_order_relaxed) < total)
+				{
+					if (!values.try_pop(value))
+					{
+						std::this_thread::yield();
+						continue;
+					}
+					if (value < total)
+						seen[value].fetch_add(1, std::memory_order_relaxed);
+					local_sum += value;
+					popped.fetch_add(1, std::memory_order_relaxed);
+				}
+				sum.fetch_add(local_sum);
+			});
+	for (auto& worker : workers)
+		worker.join();
+
+	bool exactly_once = true;
+	for (auto& count : seen)
+		exactly_once = exactly_once && count.load() == 1;
+	check(exactly_once, "every pushed value is popped exactly once");
+	check(sum.load() == static_cast<std::uint64_t>(total) * (total - 1) / 2, "sum of popped values matches");
+	check(values.empty(), "stack is empty after all pops");
+}
+
+template<std::size_t Slots>
+static void testMixed(std::size_t threads, std::size_t per_thread)
+{
+	elimination_stack<std::uint64_t, std::allocator<std::uint64_t>, Slots> values;
+	std::atomic<std::uint64_t> pushed_sum{ 0 };
+	std::atomic<std::uint64_t> popped_sum{ 0 };
+
+	std::vector<std::thread> workers;
+	for (std::size_t t = 0; t < 2 * threads; ++t)
+		workers.emplace_back([&, t]
+			{
+				std::uint64_t pushed = 0, popped = 0, value;
+				for (std::size_t i = 0; i < per_thread; ++i)
+				{
+					value = t * per_thread + i;
+					values.push(value);
+					pushed += value;
+					try
+					{
+						popped += values.pop(); /* Может снять чужое значение, сумма при этом сходится */
+					}
+					catch (const EStackEmpty&)
+					{}
+				}
+				pushed_sum.fetch_add(pushed);
+				popped_sum.fetch_add(popped);
+			});
+	for (auto& worker : workers)
+		worker.join();
+
+	std::uint64_t value, rest = 0;
+	while (values.try_pop(value))
+		rest += value;
+	check(popped_sum.load() + rest == pushed_sum.load(), "mixed push/pop loses no values");
+}
+
+
+int main(int argc, char** argv)
+{
+	const std::size_t threads = argc > 1 ? std::stoul(argv[1]) : 4;
+	const std::size_t per_thread = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+	testProducersConsumers<1>(threads, per_thread);
+	testProducersConsumers<16>(threads, per_thread);
+	testMixed<1>(threads, per_thread);
+	testMixed<16>(threads, per_thread);
+
+	if (failures)
+		return 1;
+	std::cout << "elimination_stack_test: OK\n";
+	return 0;
+}
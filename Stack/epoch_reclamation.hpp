@@ -0,0 +1,436 @@
+﻿#ifndef _epoch_reclamation_hpp
+#define _epoch_reclamation_hpp
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+*  Отложенное освобождение памяти по эпохам (epoch-based reclamation).
+*  Поток, читающий общие узлы, держит epoch_guard: пока он жив, поток "закреплен" в текущей эпохе.
+*  Снятый из структуры узел не освобождается сразу, а отдается в retire вместе с эпохой снятия.
+*  Глобальная эпоха сдвигается, только когда все закрепленные потоки видели текущую, поэтому
+*  через две эпохи после снятия ни один читатель уже не может держать указатель на узел - его освобождаем.
+*  У каждого потока свой список снятых узлов (epoch_participant), освобождение идет пачками
+*  раз в batch_size снятий, так что стоимость сдвига эпохи и обхода потоков размазана по операциям.
+*  Снятия из потоков без epoch_participant идут в общий список под мьютексом.
+*  Все epoch_participant должны быть уничтожены раньше epoch_domain.
+*/
+class epoch_participant;
+
+/* Домен: глобальная эпоха, записи потоков и общий список снятых узлов */
+class epoch_domain final
+{
+	friend class epoch_participant;
+	friend class epoch_guard;
+public:
+	using release_type = void (*)(void* pointer, std::size_t count) noexcept; /* Освобождает снятый блок */
+
+	/* Конструкторы и деструктор */
+	explicit epoch_domain(std::size_t batch_size = 64);
+	epoch_domain(const epoch_domain& oth) = delete;
+	epoch_domain(epoch_domain&& oth) = delete;
+	~epoch_domain(); /* Освобождает все, что осталось; потоков в домене быть не должно */
+
+	/* Операторы */
+	epoch_domain& operator=(const epoch_domain& oth) = delete;
+	epoch_domain& operator=(epoch_domain&& oth) = delete;
+	/* Методы */
+	std::uint64_t epoch() const noexcept; /* Текущая глобальная эпоха */
+
+	void retire(void* pointer, release_type release, std::size_t count); /* Откладывает release(pointer, count) через участника текущего потока */
+	template<typename Type>
+	void retire(Type* object); /* Откладывает delete object */
+	std::size_t collect(); /* Пробует сдвинуть эпоху и освободить готовое; возвращает число освобожденных блоков */
+private:
+	/* Запись потока: эпоха, в которой он закреплен, и бит "закреплен" в младшем разряде */
+	struct Record final
+	{
+		std::atomic<std::uint64_t> state{ 0 };
+		std::atomic<bool> in_use{ true };
+		Record* next = nullptr;
+	};
+
+	/* Снятый блок и эпоха, в которой его сняли */
+	struct Retired final
+	{
+		void* pointer;
+		release_type release;
+		std::size_t count;
+		std::uint64_t epoch;
+	};
+
+	Record* acquire_record(); /* Берет свободную запись или добавляет новую */
+	bool try_advance() noexcept; /* Сдвигает эпоху, если все закрепленные потоки в текущей */
+	static std::size_t release_ready(std::vector<Retired>& retired, std::uint64_t epoch) noexcept; /* Освобождает блоки, снятые не позже epoch - 2 */
+	std::size_t collect_orphans() noexcept; /* То же для общего списка, если мьютекс свободен */
+
+	/* Поля */
+	std::atomic<std::uint64_t> global_epoch{ 2 }; /* С двойки, чтобы epoch - 2 не уходило ниже нуля */
+	std::atomic<Record*> records{ nullptr };
+	const std::size_t batch_size;
+
+	std::mutex orphans_mutex{};
+	std::vector<Retired> orphans{}; /* Снятое потоками без участника и оставшееся от ушедших участников */
+};
+
+
+/*
+*  Участник домена: один на поток, живет в этом потоке.
+*  Хранит собственный список снятых блоков и регистрирует себя как участника текущего потока,
+*  чтобы epoch_domain::retire и deferred_allocator находили его без синхронизации.
+*/
+class epoch_participant final
+{
+	friend class epoch_domain;
+	friend class epoch_guard;
+public:
+	/* Конструкторы и деструктор */
+	explicit epoch_participant(epoch_domain& domain);
+	epoch_participant(const epoch_participant& oth) = delete;
+	epoch_participant(epoch_participant&& oth) = delete;
+	~epoch_participant(); /* Неосвобожденное отдает в общий список домена */
+
+	/* Операторы */
+	epoch_participant& operator=(const epoch_participant& oth) = delete;
+	epoch_participant& operator=(epoch_participant&& oth) = delete;
+	/* Методы */
+	void retire(void* pointer, epoch_domain::release_type release, std::size_t count); /* Откладывает release(pointer, count) */
+	std::size_t collect(); /* Пробует сдвинуть эпоху и освободить готовое из своего списка */
+	std::size_t pending() const noexcept; /* Сколько блоков ждет освобождения */
+private:
+
+	static std::vector<epoch_participant*>& enrolled() noexcept; /* Участники текущего потока (обычно один) */
+	static epoch_participant* current(const epoch_domain& domain) noexcept; /* Участник текущего потока в домене или nullptr */
+
+	epoch_domain& domain;
+	epoch_domain::Record* record;
+	std::size_t depth = 0; /* Вложенность epoch_guard */
+	std::size_t since_collect = 0;
+	std::vector<epoch_domain::Retired> retired{};
+};
+
+
+/* Закрепление потока в эпохе на время жизни объекта; вложенные guard допустимы */
+class epoch_guard final
+{
+public:
+	/* Конструкторы и деструктор */
+	explicit epoch_guard(epoch_participant& participant) noexcept;
+	epoch_guard(const epoch_guard& oth) = delete;
+	epoch_guard(epoch_guard&& oth) = delete;
+	~epoch_guard();
+
+	/* Операторы */
+	epoch_guard& operator=(const epoch_guard& oth) = delete;
+	epoch_guard& operator=(epoch_guard&& oth) = delete;
+private:
+
+	epoch_participant& participant;
+};
+
+
+/*
+*  "Stdlike" аллокатор, который откладывает освобождение через epoch_domain.
+*  Подключается к list как Alloc: AllocTraits::deallocate узла не возвращает память сразу,
+*  а снимает ее в домен, и читатель, закрепленный epoch_guard, может дочитать узел.
+*  Деструктор элемента list вызывает сразу, откладывается только память узла
+*  (указатели prev и next в ней остаются читаемыми).
+*  Копии и rebind-копии с одним доменом равны. Конструктора по умолчанию нет: домен передается явно.
+*/
+template<typename Type>
+class deferred_allocator final
+{
+	template<typename Other>
+	friend class deferred_allocator;
+public:
+	/* Типы */
+	using value_type = Type;
+	using pointer = Type*;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using is_always_equal = std::false_type;
+
+	/* Конструкторы и деструктор */
+	explicit deferred_allocator(epoch_domain& domain) noexcept;
+	deferred_allocator(const deferred_allocator& oth) noexcept = default;
+	template<typename Other>
+	deferred_allocator(const deferred_allocator<Other>& oth) noexcept;
+	~deferred_allocator() = default;
+
+	/* Операторы */
+	deferred_allocator& operator=(const deferred_allocator& oth) noexcept = default;
+	bool operator==(const deferred_allocator& oth) const noexcept;
+	bool operator!=(const deferred_allocator& oth) const noexcept;
+	/* Методы */
+	Type* allocate(std::size_t count); /* Выделяет память под count объектов */
+	void deallocate(Type* ptr, std::size_t count) noexcept; /* Снимает память в домен, освобождение - через две эпохи */
+	epoch_domain& domain() const noexcept;
+private:
+
+	static void release(void* pointer, std::size_t count) noexcept;
+
+	epoch_domain* owner;
+};
+
+
+epoch_domain::epoch_domain(std::size_t batch_size)
+	: batch_size(batch_size > 0 ? batch_size : 1)
+{}
+
+epoch_domain::~epoch_domain()
+{
+	for (Retired& item : orphans)
+		item.release(item.pointer, item.count);
+	for (Record* temp = records.load(std::memory_order_relaxed); temp;)
+	{
+		Record* next = temp->next;
+		delete temp;
+		temp = next;
+	}
+}
+
+std::uint64_t epoch_domain::epoch() const noexcept
+{
+	return global_epoch.load(std::memory_order_acquire);
+}
+
+void epoch_domain::retire(void* pointer, release_type release, std::size_t count)
+{
+	if (epoch_participant* participant = epoch_participant::current(*this))
+	{
+		participant->retire(pointer, release, count);
+		return;
+	}
+
+	bool full;
+	{
+		std::lock_guard<std::mutex> lock(orphans_mutex);
+		orphans.push_back(Retired{ pointer, release, count, global_epoch.load(std::memory_order_seq_cst) });
+		full = orphans.size() % batch_size == 0;
+	}
+	if (full)
+		collect();
+}
+
+template<typename Type>
+void epoch_domain::retire(Type* object)
+{
+	retire(object, [](void* pointer, std::size_t) noexcept { delete static_cast<Type*>(pointer); }, 1);
+}
+
+std::size_t epoch_domain::collect()
+{
+	if (epoch_participant* participant = epoch_participant::current(*this))
+		return participant->collect();
+
+	try_advance();
+	return collect_orphans();
+}
+
+epoch_domain::Record* epoch_domain::acquire_record()
+{
+	for (Record* temp = records.load(std::memory_order_acquire); temp; temp = temp->next)
+	{
+		bool free = false;
+		if (temp->in_use.compare_exchange_strong(free, true, std::memory_order_acq_rel))
+			return temp;
+	}
+
+	Record* record = new Record();
+	record->next = records.load(std::memory_order_relaxed);
+	while (!records.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed))
+		;
+	return record;
+}
+
+bool epoch_domain::try_advance() noexcept
+{
+	std::uint64_t current = global_epoch.load(std::memory_order_seq_cst);
+	for (Record* temp = records.load(std::memory_order_acquire); temp; temp = temp->next)
+	{
+		std::uint64_t state = temp->state.load(std::memory_order_seq_cst);
+		if ((state & 1) && (state >> 1) != current) /* Закрепленный поток еще в прошлой эпохе */
+			return false;
+	}
+	return global_epoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+}
+
+std::size_t epoch_domain::release_ready(std::vector<Retired>& retired, std::uint64_t epoch) noexcept
+{
+	/* Эпохи в списке не убывают, поэтому готовые блоки лежат в начале */
+	std::size_t ready = 0;
+	while (ready < retired.size() && retired[ready].epoch + 2 <= epoch)
+	{
+		retired[ready].release(retired[ready].pointer, retired[ready].count);
+		++ready;
+	}
+	retired.erase(retired.begin(), retired.begin() + static_cast<std::ptrdiff_t>(ready));
+	return ready;
+}
+
+std::size_t epoch_domain::collect_orphans() noexcept
+{
+	std::unique_lock<std::mutex> lock(orphans_mutex, std::try_to_lock);
+	if (!lock.owns_lock()) /* Общий список сейчас разбирает другой поток */
+		return 0;
+	return release_ready(orphans, global_epoch.load(std::memory_order_seq_cst));
+}
+
+
+epoch_participant::epoch_participant(epoch_domain& domain)
+	: domain(domain),
+	record(domain.acquire_record())
+{
+	try
+	{
+		enrolled().push_back(this);
+	}
+	catch (...)
+	{
+		record->in_use.store(false, std::memory_order_release);
+		throw;
+	}
+}
+
+epoch_participant::~epoch_participant()
+{
+	std::vector<epoch_participant*>& list = enrolled();
+	for (auto it = list.begin(); it != list.end(); ++it)
+		if (*it == this)
+		{
+			list.erase(it);
+			break;
+		}
+
+	collect();
+	if (!retired.empty())
+	{
+		std::lock_guard<std::mutex> lock(domain.orphans_mutex);
+		/* Эпохи общего списка тоже не должны убывать: вставляем по месту, список обычно короткий */
+		for (epoch_domain::Retired& item : retired)
+		{
+			auto position = domain.orphans.end();
+			while (position != domain.orphans.begin() && (position - 1)->epoch > item.epoch)
+				--position;
+			domain.orphans.insert(position, item);
+		}
+	}
+	record->state.store(0, std::memory_order_release);
+	record->in_use.store(false, std::memory_order_release);
+}
+
+void epoch_participant::retire(void* pointer, epoch_domain::release_type release, std::size_t count)
+{
+	retired.push_back(epoch_domain::Retired{ pointer, release, count, domain.global_epoch.load(std::memory_order_seq_cst) });
+	if (++since_collect >= domain.batch_size) /* Освобождаем пачками, а не на каждом снятии */
+	{
+		since_collect = 0;
+		collect();
+	}
+}
+
+std::size_t epoch_participant::collect()
+{
+	domain.try_advance();
+	std::uint64_t epoch = domain.global_epoch.load(std::memory_order_seq_cst);
+	return epoch_domain::release_ready(retired, epoch) + domain.collect_orphans();
+}
+
+std::size_t epoch_participant::pending() const noexcept
+{
+	return retired.size();
+}
+
+std::vector<epoch_participant*>& epoch_participant::enrolled() noexcept
+{
+	thread_local std::vector<epoch_participant*> participants;
+	return participants;
+}
+
+epoch_participant* epoch_participant::current(const epoch_domain& domain) noexcept
+{
+	for (epoch_participant* participant : enrolled())
+		if (&participant->domain == &domain)
+			return participant;
+	return nullptr;
+}
+
+
+epoch_guard::epoch_guard(epoch_participant& participant) noexcept
+	: participant(participant)
+{
+	if (participant.depth++ > 0)
+		return;
+
+	/* Объявляем эпоху и только потом читаем общие данные: барьер не дает чтениям обогнать запись */
+	std::uint64_t epoch = participant.domain.global_epoch.load(std::memory_order_relaxed);
+	participant.record->state.store((epoch << 1) | 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+epoch_guard::~epoch_guard()
+{
+	if (--participant.depth > 0)
+		return;
+
+	std::uint64_t state = participant.record->state.load(std::memory_order_relaxed);
+	participant.record->state.store(state & ~std::uint64_t(1), std::memory_order_release); /* Все чтения узлов завершены */
+}
+
+
+template<typename Type>
+deferred_allocator<Type>::deferred_allocator(epoch_domain& domain) noexcept
+	: owner(&domain)
+{}
+
+template<typename Type>
+template<typename Other>
+deferred_allocator<Type>::deferred_allocator(const deferred_allocator<Other>& oth) noexcept
+	: owner(oth.owner)
+{}
+
+template<typename Type>
+bool deferred_allocator<Type>::operator==(const deferred_allocator& oth) const noexcept
+{
+	return owner == oth.owner;
+}
+
+template<typename Type>
+bool deferred_allocator<Type>::operator!=(const deferred_allocator& oth) const noexcept
+{
+	return owner != oth.owner;
+}
+
+template<typename Type>
+Type* deferred_allocator<Type>::allocate(std::size_t count)
+{
+	return std::allocator<Type>().allocate(count);
+}
+
+template<typename Type>
+void deferred_allocator<Type>::deallocate(Type* ptr, std::size_t count) noexcept
+{
+	owner->retire(ptr, &deferred_allocator::release, count); /* bad_alloc списка снятых здесь - terminate: освободить сразу небезопасно */
+}
+
+template<typename Type>
+epoch_domain& deferred_allocator<Type>::domain() const noexcept
+{
+	return *owner;
+}
+
+template<typename Type>
+void deferred_allocator<Type>::release(void* pointer, std::size_t count) noexcept
+{
+	std::allocator<Type>().deallocate(static_cast<Type*>(pointer), count);
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,222 @@
+﻿#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "epoch_reclamation.hpp"
+#include "list.hpp"
+
+/*
+*  Нагрузочная проверка epoch_reclamation.
+*  Стек Трайбера без тегов версий: снятый узел отдается в retire, пока другие потоки могут его читать.
+*  Если узел освободить раньше времени, ASan поймает чтение освобожденной памяти, а переиспользование
+*  адреса даст ABA и потерянные или повторные значения. Каждое значение должно быть снято ровно один раз,
+*  а после уничтожения домена не должно остаться живых узлов.
+*  Отдельно: пока поток держит epoch_guard, снятое не освобождается; list с deferred_allocator
+*  освобождает узлы пачками и не копит их.
+*      g++ -std=c++17 -O1 -g -pthread -fsanitize=address epoch_reclamation_test.cpp -o epoch_reclamation_test
+*      g++ -std=c++17 -O1 -g -pthread -fsanitize=thread epoch_reclamation_test.cpp -o epoch_reclamation_test
+*  Аргументы: число потоков (по умолчанию 4) и операций на поток (по умолчанию 100000).
+*/
+
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+}
+
+/* Считает живые экземпляры */
+struct Counted final
+{
+	static inline std::atomic<long> live{ 0 };
+
+	Counted() noexcept { live.fetch_add(1, std::memory_order_relaxed); }
+	~Counted() { live.fetch_sub(1, std::memory_order_relaxed); }
+};
+
+/* Стек Трайбера, узлы которого освобождаются через epoch_domain */
+class treiber_stack final
+{
+public:
+	explicit treiber_stack(epoch_domain& domain) noexcept
+		: domain(domain)
+	{}
+
+	~treiber_stack()
+	{
+		for (Node* temp = head.load(std::memory_order_relaxed); temp;)
+		{
+			Node* next = temp->next;
+			delete temp;
+			temp = next;
+		}
+	}
+
+	void push(std::uint64_t value)
+	{
+		Node* node = new Node{ value, head.load(std::memory_order_relaxed), {} };
+		while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+			;
+	}
+
+	bool try_pop(epoch_participant& participant, std::uint64_t& value)
+	{
+		Node* node;
+		{
+			epoch_guard guard(participant); /* node->next читаем, пока узел может снимать другой поток */
+			node = head.load(std::memory_order_acquire);
+			while (node && !head.compare_exchange_weak(node, node->next, std::memory_order_acquire, std::memory_order_acquire))
+				;
+			if (!node)
+				return false;
+			value = node->value;
+		}
+		domain.retire(node);
+		return true;
+	}
+private:
+	struct Node final
+	{
+		std::uint64_t value;
+		Node* next;
+		Counted counted;
+	};
+
+	epoch_domain& domain;
+	std::atomic<Node*> head{ nullptr };
+};
+
+static void testTreiberStack(std::size_t threads, std::size_t per_thread)
+{
+	{
+		epoch_domain domain;
+		treiber_stack values(domain);
+		const std::size_t total = threads * per_thread;
+		std::vector<std::atomic<std::uint32_t>> seen(total); /* Сколько раз снято каждое значение */
+		std::atomic<std::size_t> popped{ 0 };
+
+		std::vector<std::thread> workers;
+		for (std::size_t t = 0; t < threads; ++t)
+			workers.emplace_back([&, t]
+				{
+					epoch_participant participant(domain);
+					std::uint64_t value;
+					for (std::size_t i = 0; i < per_thread; ++i)
+					{
+						values.push(t * per_thread + i); /* Кладем и сразу снимаем: узлы постоянно уходят в retire */
+						if (values.try_pop(participant, value))
+						{
+							if (value < total)
+								seen[value].fetch_add(1, std::memory_order_relaxed);
+							popped.fetch_add(1, std::memory_order_relaxed);
+						}
+					}
+				});
+		for (auto& worker : workers)
+			worker.join();
+
+		epoch_participant participant(domain);
+		for (std::uint64_t value; values.try_pop(participant, value);)
+		{
+			if (value < total)
+				seen[value].fetch_add(1, std::memory_order_relaxed);
+			popped.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		bool exactly_once = popped.load() == total;
+		for (auto& count : seen)
+			exactly_once = exactly_once && count.load() == 1;
+		check(exactly_once, "every pushed value is popped exactly once");
+	}
+	check(Counted::live.load() == 0, "domain releases every retired node");
+}
+
+static void testGuardBlocksRelease()
+{
+	Counted::live.store(0);
+	epoch_domain domain(1);
+	std::atomic<int> stage{ 0 };
+
+	std::thread reader([&]
+		{
+			epoch_participant participant(domain);
+			{
+				epoch_guard guard(participant);
+				stage.store(1);
+				while (stage.load() != 2)
+					std::this_thread::yield();
+			}
+			stage.store(3);
+		});
+	while (stage.load() != 1)
+		std::this_thread::yield();
+
+	{
+		epoch_participant participant(domain);
+		for (int i = 0; i < 100; ++i)
+			domain.retire(new Counted());
+		participant.collect();
+		check(Counted::live.load() == 100, "nothing is released while a reader is pinned");
+
+		stage.store(2);
+		while (stage.load() != 3)
+			std::this_thread::yield();
+		for (int i = 0; i < 3; ++i)
+			participant.collect();
+		check(Counted::live.load() == 0, "retired objects are released once the reader unpins");
+		check(participant.pending() == 0, "participant retire list is empty after release");
+	}
+	reader.join();
+}
+
+static void testDeferredList(std::size_t per_thread)
+{
+	const std::size_t batch = 64;
+	epoch_domain domain(batch);
+	epoch_participant participant(domain);
+	list<int, deferred_allocator<int>> values{ deferred_allocator<int>(domain) };
+
+	std::size_t most_pending = 0;
+	for (std::size_t i = 0; i < per_thread; ++i)
+	{
+		values.push_back(static_cast<int>(i));
+		if (i % 3 == 2)
+		{
+			values.pop_back();
+			values.pop_back();
+		}
+		if (participant.pending() > most_pending)
+			most_pending = participant.pending();
+	}
+	check(most_pending <= 3 * batch, "deferred_allocator frees list nodes in batches");
+
+	values.clear();
+	for (int i = 0; i < 3; ++i)
+		participant.collect();
+	check(participant.pending() == 0, "cleared list nodes are released after two epochs");
+}
+
+
+int main(int argc, char** argv)
+{
+	const std::size_t threads = argc > 1 ? std::stoul(argv[1]) : 4;
+	const std::size_t per_thread = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+	testTreiberStack(threads, per_thread);
+	testGuardBlocksRelease();
+	testDeferredList(per_thread);
+
+	if (failures)
+		return 1;
+	std::cout << "epoch_reclamation_test: OK\n";
+	return 0;
+}
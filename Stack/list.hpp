@@ -1,8 +1,12 @@
-﻿git@github.com:NOOB2033/Stack.git#ifndef _list_hpp
+﻿#ifndef _list_hpp
 #define _list_hpp
 
 
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
 
 /*
 *  Одноопоточный контейнер с поддержкой пользовательского "stdlike" аллокатора
@@ -17,6 +21,9 @@ public:
 	using value_type = Type;
 	using pointer = Type*;
 	using reference = Type&;
+
+	template<bool isConst>
+	class base_iterator; /* Итератор, определен ниже */
 	/* Конструкторы и деструктор */
 	explicit list(const Alloc& alloc = Alloc());
 	list(std::size_t size, const Type& value = Type(), const Alloc& alloc = Alloc());
@@ -26,7 +33,8 @@ public:
 
 	/* Операторы */
 	list& operator=(const list& oth) &;
-	list& operator=(list&& oth) & noexcept;
+	list& operator=(list&& oth) & noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value
+		|| std::allocator_traits<Alloc>::is_always_equal::value); /* При неравных аллокаторах без распространения - поэлементно */
 	/* Методы */
 	Type& front(); /* Возвращает ссылку на начало списка */
 	const Type& front() const; /* Возвращает константную ссылку на начало списка */
@@ -47,8 +55,26 @@ public:
 	template<typename... Args>
 	void emplace_back(Args&&... args); /* Создает в конце элемент от входящих аргументов */
 
+	template<typename InputIt>
+	void push_range(InputIt first, InputIt last); /* Кладет диапазон в конец; при исключении список не меняется */
+
 	void pop_front() noexcept; /* Удаляет элемент из начала */
 	void pop_back() noexcept; /* Удаляет элемент из конца */
+
+	void swap(list& oth) noexcept; /* Обменивается узлами с oth; аллокаторы меняются, только если это разрешает propagate_on_container_swap */
+	/*
+	*  Операции над узлами: элементы не копируются и не перемещаются, узлы только перевязываются.
+	*  Узлы oth освобождает потом наш аллокатор, поэтому аллокаторы должны быть равны, иначе бросаем runtime_error.
+	*/
+	void splice(base_iterator<true> pos, list& oth); /* Переносит все узлы oth перед pos за O(1) */
+	void splice(base_iterator<true> pos, list& oth, base_iterator<true> it); /* Переносит узел it из oth перед pos за O(1) */
+	void append(list&& oth); /* Переносит все узлы oth в конец за O(1); при разных аллокаторах - поэлементным перемещением */
+
+	/* Слияние и сортировка устойчивы, сравнение не должно бросать исключений */
+	template<typename Compare = std::less<>>
+	void merge(list& oth, Compare less = Compare()); /* Сливает отсортированный oth в отсортированный список */
+	template<typename Compare = std::less<>>
+	void sort(Compare less = Compare()); /* Сортировка слиянием перевязкой узлов, O(n log n) */
 private:
 	/* Узел списка */
 	struct Node final
@@ -63,10 +89,15 @@ private:
 			: value(value)
 		{}
 
-		Node(Type&& value) noexcept
+		Node(Type&& value) noexcept(std::is_nothrow_move_constructible_v<Type>)
 			: value(std::move(value))
 		{}
 
+		template<typename... Args> /* Для emplace: элемент создается прямо в узле от любых аргументов */
+		Node(std::in_place_t, Args&&... args)
+			: value(std::forward<Args>(args)...)
+		{}
+
 		~Node() = default;
 	};
 public:
@@ -86,14 +117,21 @@ public:
 		using curTPtr = std::conditional_t<isConst, const Type*, Type*>;
 
 		Node* ptr = nullptr;
+
+		friend class list; /* Операциям над узлами нужен сам узел */
+		template<bool> friend class base_iterator;
 	public:
 		/* Типы */
 		using iterator_category = std::bidirectional_iterator_tag;
+		using difference_type = std::ptrdiff_t;
 		using value_type = Type;
 		using reference = Type&;
 		using pointer = Type*;
 
 		base_iterator(Node* ptr = nullptr) : ptr(ptr) {}
+		base_iterator(const base_iterator& another) = default;
+		template<bool isOthConst, typename = std::enable_if_t<isConst && !isOthConst>> /* iterator -> const_iterator */
+		base_iterator(const base_iterator<isOthConst>& another) : ptr(another.ptr) {}
 		~base_iterator() = default;
 
 		/* Операторы */
@@ -156,7 +194,18 @@ private:
 	/* Поля */
 	Node* head = nullptr;
 	Node* tail = nullptr;
+	std::size_t count = 0; /* Количество элементов, поддерживается всеми модифицирующими методами */
 	RebindAlloc rebind_alloc{};
+
+	void checkAllocator(const list& oth) const; /* Бросает runtime_error, если узлы oth нельзя освобождать нашим аллокатором */
+	void link(Node* pos, Node* first, Node* last) noexcept; /* Вставляет цепочку [first, last] перед pos, nullptr - конец */
+	void unlink(Node* node) noexcept; /* Вынимает узел, не освобождая его */
+	void restoreLinks(Node* first) noexcept; /* По цепочке next восстанавливает prev, head и tail */
+
+	template<typename Compare>
+	static Node* mergeChains(Node* first, Node* second, Compare& less); /* Сливает две цепочки next, при равенстве первой идет first */
+	template<typename Compare>
+	static Node* sortChain(Node* first, std::size_t size, Compare& less); /* Сортирует цепочку next из size узлов */
 public:
 	/* Тип итератора */
 	using iterator = base_iterator<false>;
@@ -219,21 +268,21 @@ list<Type, Alloc>::list(std::size_t size, const Type& value, const Alloc& alloc)
 			AllocTraits::construct(rebind_alloc, tail->next, value);
 			tail->next->prev = tail;
 		}
+		count = counter;
 	}
 	catch (...)
-	{ /* Если исключение, то сначала уничтожаем объекты по счетчику, затем деаллоцируем память */
+	{ /* Если исключение, то уничтожаем и деаллоцируем объекты по счетчику, затем недосконструированный узел */
 		Node* temp = head;
 		for (std::size_t i = 0; i < counter; ++i)
 		{
 			Node* _temp = temp;
 			temp = temp->next;
 			AllocTraits::destroy(rebind_alloc, _temp);
+			AllocTraits::deallocate(rebind_alloc, _temp, 1);
 		}
-		for (temp = head; head; temp = head)
-		{
-			head = head->next;
+		if (temp) /* Память выделена, но конструктор бросил исключение - поля узла не инициализированы */
 			AllocTraits::deallocate(rebind_alloc, temp, 1);
-		}
+		head = nullptr;
 		tail = nullptr;
 		throw; /* Пробрассываем исключение */
 	}
@@ -261,6 +310,7 @@ list<Type, Alloc>::list(const list& oth)
 			tail->next->prev = tail;
 			tail = tail->next;
 		}
+		count = counter;
 	}
 	catch (...)
 	{
@@ -270,12 +320,11 @@ list<Type, Alloc>::list(const list& oth)
 			Node* _temp = temp;
 			temp = temp->next;
 			AllocTraits::destroy(rebind_alloc, _temp);
+			AllocTraits::deallocate(rebind_alloc, _temp, 1);
 		}
-		for (temp = head; head; temp = head)
-		{
-			head = head->next;
+		if (temp)
 			AllocTraits::deallocate(rebind_alloc, temp, 1);
-		}
+		head = nullptr;
 		tail = nullptr;
 		throw;
 	}
@@ -285,10 +334,12 @@ template<typename Type, typename Alloc>
 list<Type, Alloc>::list(list&& oth) noexcept
 	: head(oth.head),
 	tail(oth.tail),
+	count(oth.count),
 	rebind_alloc(std::move(oth.rebind_alloc))
 {
 	oth.head = nullptr;
 	oth.tail = nullptr;
+	oth.count = 0;
 }
 
 template<typename Type, typename Alloc>
@@ -306,9 +357,13 @@ list<Type, Alloc>& list<Type, Alloc>::operator=(const list& oth) &
 
 	clear();
 	/* Определяем, должны ли мы создавать копию пула аллокатора, или просто копию без нового пула */
-	if (std::allocator_traits<Alloc>::propagate_on_container_copy_assignment::value
-		&& rebind_alloc != oth.rebind_alloc)
-		rebind_alloc = oth.rebind_alloc;
+	/* if constexpr: у аллокаторов без распространения (например, std::pmr) присваивание может быть удалено */
+	if constexpr (std::allocator_traits<Alloc>::propagate_on_container_copy_assignment::value)
+		if (rebind_alloc != oth.rebind_alloc)
+			rebind_alloc = oth.rebind_alloc;
+
+	if (oth.head == nullptr) /* Копировать нечего */
+		return *this;
 
 	head = AllocTraits::allocate(rebind_alloc, 1);
 	std::size_t counter = 0;
@@ -324,6 +379,7 @@ list<Type, Alloc>& list<Type, Alloc>::operator=(const list& oth) &
 			tail->next->prev = tail;
 			tail = tail->next;
 		}
+		count = counter;
 	}
 	catch (...)
 	{
@@ -333,12 +389,11 @@ list<Type, Alloc>& list<Type, Alloc>::operator=(const list& oth) &
 			Node* _temp = temp;
 			temp = temp->next;
 			AllocTraits::destroy(rebind_alloc, _temp);
+			AllocTraits::deallocate(rebind_alloc, _temp, 1);
 		}
-		for (temp = head; head; temp = head)
-		{
-			head = head->next;
+		if (temp)
 			AllocTraits::deallocate(rebind_alloc, temp, 1);
-		}
+		head = nullptr;
 		tail = nullptr;
 		throw;
 	}
@@ -346,21 +401,32 @@ list<Type, Alloc>& list<Type, Alloc>::operator=(const list& oth) &
 }
 
 template<typename Type, typename Alloc>
-list<Type, Alloc>& list<Type, Alloc>::operator=(list&& oth) & noexcept
+list<Type, Alloc>& list<Type, Alloc>::operator=(list&& oth) & noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value
+		|| std::allocator_traits<Alloc>::is_always_equal::value)
 {
 	if (this == std::addressof(oth))
 		return *this;
 
 	clear();
 	/* То же самое, что и в operator=, только сейчас муваем */
-	if (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value
-		&& rebind_alloc != oth.rebind_alloc)
-		rebind_alloc = std::move(oth.rebind_alloc);
+	if constexpr (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value)
+	{
+		if (rebind_alloc != oth.rebind_alloc)
+			rebind_alloc = std::move(oth.rebind_alloc);
+	}
+	else if (rebind_alloc != oth.rebind_alloc)
+	{ /* Узлы oth принадлежат чужому ресурсу (например, другой арене pmr) - забирать их нельзя, перемещаем элементы в свои узлы */
+		push_range(std::make_move_iterator(oth.begin()), std::make_move_iterator(oth.end()));
+		oth.clear();
+		return *this;
+	}
 
 	head = oth.head;
 	oth.head = nullptr;
 	tail = oth.tail;
 	oth.tail = nullptr;
+	count = oth.count;
+	oth.count = 0;
 	return *this;
 }
 
@@ -409,12 +475,7 @@ bool list<Type, Alloc>::empty() const noexcept
 template<typename Type, typename Alloc>
 std::size_t list<Type, Alloc>::size() const noexcept
 {
-	std::size_t size = 0;
-	for (auto iter : *this)
-	{
-		++size;
-	}
-	return size;
+	return count;
 }
 
 template<typename Type, typename Alloc>
@@ -428,6 +489,7 @@ void list<Type, Alloc>::clear() noexcept
 		AllocTraits::deallocate(rebind_alloc, temp, 1);
 	}
 	tail = nullptr;
+	count = 0;
 }
 
 template<typename Type, typename Alloc>
@@ -456,6 +518,7 @@ void list<Type, Alloc>::push_front(const Type& value)
 		head = temp;
 		tail = head;
 	}
+	++count;
 }
 
 template<typename Type, typename Alloc>
@@ -484,6 +547,7 @@ void list<Type, Alloc>::push_front(Type&& value)
 		head = temp;
 		tail = head;
 	}
+	++count;
 }
 
 template<typename Type, typename Alloc>
@@ -512,6 +576,7 @@ void list<Type, Alloc>::push_back(const Type& value)
 		tail = temp;
 		head = tail;
 	}
+	++count;
 }
 
 template<typename Type, typename Alloc>
@@ -540,6 +605,7 @@ void list<Type, Alloc>::push_back(Type&& value)
 		tail = temp;
 		head = tail;
 	}
+	++count;
 }
 
 template<typename Type, typename Alloc>
@@ -550,7 +616,7 @@ void list<Type, Alloc>::emplace_front(Args&& ...args)
 
 	try
 	{
-		AllocTraits::construct(rebind_alloc, temp, std::forward<Args>(args)...);
+		AllocTraits::construct(rebind_alloc, temp, std::in_place, std::forward<Args>(args)...);
 	}
 	catch (...)
 	{
@@ -569,6 +635,7 @@ void list<Type, Alloc>::emplace_front(Args&& ...args)
 		head = temp;
 		tail = head;
 	}
+	++count;
 }
 
 template<typename Type, typename Alloc>
@@ -579,7 +646,7 @@ void list<Type, Alloc>::emplace_back(Args&& ...args)
 
 	try
 	{
-		AllocTraits::construct(rebind_alloc, temp, std::forward<Args>(args)...);
+		AllocTraits::construct(rebind_alloc, temp, std::in_place, std::forward<Args>(args)...);
 	}
 	catch (...)
 	{
@@ -598,6 +665,52 @@ void list<Type, Alloc>::emplace_back(Args&& ...args)
 		tail = temp;
 		head = tail;
 	}
+	++count;
+}
+
+template<typename Type, typename Alloc>
+template<typename InputIt>
+void list<Type, Alloc>::push_range(InputIt first, InputIt last)
+{
+	if (first == last)
+		return;
+
+	/*
+	*  Сначала строим отдельную цепочку, потом подвязываем ее к хвосту за O(1).
+	*  Узлы выделяются по одному: clear и pop_* освобождают каждый узел отдельно, а allocate(n)
+	*  обязывает вернуть блок одним deallocate(p, n). Одним блоком узлы выделяет pool_allocator.
+	*/
+	Node* chain_head = AllocTraits::allocate(rebind_alloc, 1);
+	Node* chain_tail = chain_head;
+	std::size_t counter = 0;
+	try
+	{
+		AllocTraits::construct(rebind_alloc, chain_head, std::in_place, *first);
+		++counter;
+		for (++first; first != last; ++counter, chain_tail = chain_tail->next, ++first)
+		{
+			chain_tail->next = AllocTraits::allocate(rebind_alloc, 1);
+			AllocTraits::construct(rebind_alloc, chain_tail->next, std::in_place, *first);
+			chain_tail->next->prev = chain_tail;
+		}
+	}
+	catch (...)
+	{ /* Как в конструкторах: уничтожаем сконструированные узлы по счетчику, затем недосконструированный */
+		Node* temp = chain_head;
+		for (std::size_t i = 0; i < counter; ++i)
+		{
+			Node* _temp = temp;
+			temp = temp->next;
+			AllocTraits::destroy(rebind_alloc, _temp);
+			AllocTraits::deallocate(rebind_alloc, _temp, 1);
+		}
+		if (temp)
+			AllocTraits::deallocate(rebind_alloc, temp, 1);
+		throw;
+	}
+
+	link(nullptr, chain_head, chain_tail);
+	count += counter;
 }
 
 template<typename Type, typename Alloc>
@@ -615,6 +728,7 @@ void list<Type, Alloc>::pop_front() noexcept
 
 	AllocTraits::destroy(rebind_alloc, temp);
 	AllocTraits::deallocate(rebind_alloc, temp, 1);
+	--count;
 }
 
 template<typename Type, typename Alloc>
@@ -632,7 +746,188 @@ void list<Type, Alloc>::pop_back() noexcept
 
 	AllocTraits::destroy(rebind_alloc, temp);
 	AllocTraits::deallocate(rebind_alloc, temp, 1);
+	--count;
+}
+
+template<typename Type, typename Alloc>
+void list<Type, Alloc>::swap(list& oth) noexcept
+{
+	std::swap(head, oth.head);
+	std::swap(tail, oth.tail);
+	std::swap(count, oth.count);
+	if constexpr (std::allocator_traits<Alloc>::propagate_on_container_swap::value)
+	{
+		using std::swap;
+		swap(rebind_alloc, oth.rebind_alloc);
+	}
+}
+
+template<typename Type, typename Alloc>
+void list<Type, Alloc>::splice(base_iterator<true> pos, list& oth)
+{
+	if (this == std::addressof(oth) || oth.empty())
+		return;
+	checkAllocator(oth);
+
+	link(pos.ptr, oth.head, oth.tail);
+	count += oth.count;
+	oth.head = nullptr;
+	oth.tail = nullptr;
+	oth.count = 0;
+}
+
+template<typename Type, typename Alloc>
+void list<Type, Alloc>::splice(base_iterator<true> pos, list& oth, base_iterator<true> it)
+{
+	if (pos.ptr == it.ptr) /* Узел уже стоит перед самим собой */
+		return;
+	checkAllocator(oth);
+
+	oth.unlink(it.ptr);
+	--oth.count;
+	link(pos.ptr, it.ptr, it.ptr);
+	++count;
+}
+
+template<typename Type, typename Alloc>
+void list<Type, Alloc>::append(list&& oth)
+{
+	if (this == std::addressof(oth) || oth.empty())
+		return;
+
+	if (rebind_alloc == oth.rebind_alloc)
+	{
+		splice(end(), oth);
+		return;
+	}
+
+	for (Node* temp = oth.head; temp; temp = temp->next) /* Узлы чужого аллокатора перевязать нельзя */
+		push_back(std::move(temp->value));
+	oth.clear();
+}
+
+template<typename Type, typename Alloc>
+template<typename Compare>
+void list<Type, Alloc>::merge(list& oth, Compare less)
+{
+	if (this == std::addressof(oth) || oth.empty())
+		return;
+	checkAllocator(oth);
+
+	restoreLinks(mergeChains(head, oth.head, less));
+	count += oth.count;
+	oth.head = nullptr;
+	oth.tail = nullptr;
+	oth.count = 0;
+}
+
+template<typename Type, typename Alloc>
+template<typename Compare>
+void list<Type, Alloc>::sort(Compare less)
+{
+	if (count < 2)
+		return;
+
+	restoreLinks(sortChain(head, count, less));
+}
+
+template<typename Type, typename Alloc>
+void list<Type, Alloc>::checkAllocator(const list& oth) const
+{
+	if (rebind_alloc != oth.rebind_alloc)
+		throw std::runtime_error("Allocators are not equal\n");
+}
+
+template<typename Type, typename Alloc>
+void list<Type, Alloc>::link(Node* pos, Node* first, Node* last) noexcept
+{
+	Node* before = pos ? pos->prev : tail;
+	first->prev = before;
+	last->next = pos;
+	if (before)
+		before->next = first;
+	else
+		head = first;
+	if (pos)
+		pos->prev = last;
+	else
+		tail = last;
+}
+
+template<typename Type, typename Alloc>
+void list<Type, Alloc>::unlink(Node* node) noexcept
+{
+	if (node->prev)
+		node->prev->next = node->next;
+	else
+		head = node->next;
+	if (node->next)
+		node->next->prev = node->prev;
+	else
+		tail = node->prev;
+	node->prev = nullptr;
+	node->next = nullptr;
+}
+
+template<typename Type, typename Alloc>
+void list<Type, Alloc>::restoreLinks(Node* first) noexcept
+{
+	head = first;
+	tail = nullptr;
+	for (Node* temp = first; temp; temp = temp->next)
+	{
+		temp->prev = tail;
+		tail = temp;
+	}
+}
+
+template<typename Type, typename Alloc>
+template<typename Compare>
+typename list<Type, Alloc>::Node* list<Type, Alloc>::mergeChains(Node* first, Node* second, Compare& less)
+{
+	Node* result = nullptr;
+	Node** link = &result; /* Поле next, в которое пишем следующий узел */
+	while (first && second)
+	{
+		if (less(second->value, first->value)) /* Строго меньше - только тогда second раньше, так слияние устойчиво */
+		{
+			*link = second;
+			second = second->next;
+		}
+		else
+		{
+			*link = first;
+			first = first->next;
+		}
+		link = &(*link)->next;
+	}
+	*link = first ? first : second;
+	return result;
+}
+
+template<typename Type, typename Alloc>
+template<typename Compare>
+typename list<Type, Alloc>::Node* list<Type, Alloc>::sortChain(Node* first, std::size_t size, Compare& less)
+{
+	if (size < 2)
+	{
+		first->next = nullptr;
+		return first;
+	}
+
+	Node* middle = first;
+	for (std::size_t i = 1; i < size / 2; ++i)
+		middle = middle->next;
+	Node* second = middle->next;
+	middle->next = nullptr;
+	return mergeChains(sortChain(first, size / 2, less), sortChain(second, size - size / 2, less), less);
+}
+
+template<typename Type, typename Alloc>
+void swap(list<Type, Alloc>& left, list<Type, Alloc>& right) noexcept
+{
+	left.swap(right);
 }
 
 
-#endif
+#endif
\ No newline at end of file
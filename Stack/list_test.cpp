@@ -0,0 +1,298 @@
+﻿#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "list.hpp"
+
+/*
+*  Проверка счетчика элементов list при исключениях.
+*  Элемент Tracked бросает из конструктора копирования, когда счетчик копий доходит до нуля,
+*  и считает живые экземпляры: после любого исключения size() должен совпадать с числом узлов,
+*  а лишних живых элементов быть не должно.
+*  Операции над узлами (splice, merge, sort) проверяются на порядок в обе стороны, size(),
+*  устойчивость и крайние случаи: пустые списки, перенос списка в себя и узла на свое же место.
+*      g++ -std=c++17 -fsanitize=address,undefined list_test.cpp -o list_test
+*/
+
+
+/* Элемент, копирование которого бросает на заданной по счету копии */
+struct Tracked final
+{
+	static inline int live = 0; /* Живые экземпляры */
+	static inline int copies_left = -1; /* Сколько копий еще разрешено, -1 - без ограничений */
+
+	int value = 0;
+
+	explicit Tracked(int value) : value(value) { ++live; }
+	Tracked(const Tracked& oth) : value(oth.value)
+	{
+		if (copies_left == 0)
+			throw std::runtime_error("Tracked copy failed\n");
+		if (copies_left > 0)
+			--copies_left;
+		++live;
+	}
+	~Tracked() { --live; }
+	Tracked& operator=(const Tracked& oth) = delete;
+};
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+}
+
+/* size() совпадает с числом узлов при обходе */
+template<typename List>
+static bool consistent(const List& values)
+{
+	return values.size() == static_cast<std::size_t>(std::distance(values.begin(), values.end()));
+}
+
+/* Выполняет action, ожидая исключение на copies-й копии */
+template<typename Action>
+static bool throwsAfter(int copies, Action action)
+{
+	Tracked::copies_left = copies;
+	bool thrown = false;
+	try
+	{
+		action();
+	}
+	catch (const std::runtime_error&)
+	{
+		thrown = true;
+	}
+	Tracked::copies_left = -1;
+	return thrown;
+}
+
+/* Элемент с ключом сравнения и номером, по которому видна устойчивость */
+struct Keyed final
+{
+	int key = 0;
+	int order = 0;
+};
+
+static bool keyLess(const Keyed& left, const Keyed& right)
+{
+	return left.key < right.key;
+}
+
+template<typename List>
+static std::vector<int> contents(const List& values)
+{
+	return std::vector<int>(values.begin(), values.end());
+}
+
+/* Разбирает список с конца через back()/pop_back(), проверяя tail и обратные связи; список опустошается */
+static std::vector<int> drainBackwards(list<int>& values)
+{
+	std::vector<int> result;
+	while (!values.empty())
+	{
+		result.push_back(values.back());
+		values.pop_back();
+	}
+	std::reverse(result.begin(), result.end());
+	return result;
+}
+
+static list<int> makeList(std::initializer_list<int> values)
+{
+	list<int> result;
+	for (int value : values)
+		result.push_back(value);
+	return result;
+}
+
+static void testSizeConstructor()
+{
+	check(throwsAfter(3, [] { list<Tracked> values(5, Tracked(1)); }), "list(n, v) throws");
+	check(Tracked::live == 0, "list(n, v) leaves no live elements");
+}
+
+static void testCopyConstructor()
+{
+	list<Tracked> source(5, Tracked(1));
+	check(throwsAfter(2, [&] { list<Tracked> copy(source); }), "copy constructor throws");
+	check(Tracked::live == 5, "copy constructor leaves only the source alive");
+	check(source.size() == 5 && consistent(source), "copy constructor leaves the source intact");
+}
+
+static void testCopyAssignment()
+{
+	list<Tracked> source(5, Tracked(1));
+	list<Tracked> target(3, Tracked(2));
+	check(throwsAfter(4, [&] { target = source; }), "copy assignment throws");
+	check(consistent(target), "copy assignment keeps size() equal to the node count");
+	check(Tracked::live == static_cast<int>(source.size() + target.size()), "copy assignment leaves no orphaned elements");
+}
+
+static void testPushBack()
+{
+	list<Tracked> values(3, Tracked(1));
+	Tracked value(2);
+	check(throwsAfter(0, [&] { values.push_back(value); }), "push_back throws");
+	check(values.size() == 3 && consistent(values), "push_back keeps size() unchanged");
+	check(throwsAfter(0, [&] { values.push_front(value); }), "push_front throws");
+	check(values.size() == 3 && consistent(values), "push_front keeps size() unchanged");
+}
+
+static void testPushRange()
+{
+	list<Tracked> values(3, Tracked(1));
+	list<Tracked> range(6, Tracked(2));
+	check(throwsAfter(4, [&] { values.push_range(range.begin(), range.end()); }), "push_range throws");
+	check(values.size() == 3 && consistent(values), "push_range leaves the list unchanged");
+	check(Tracked::live == 9, "push_range leaves no orphaned elements");
+
+	values.push_range(range.begin(), range.end());
+	check(values.size() == 9 && consistent(values), "push_range after a failure counts every element");
+}
+
+static void testSpliceAll()
+{
+	list<int> values = makeList({ 1, 2, 3 });
+	list<int> other = makeList({ 4, 5 });
+	values.splice(std::next(values.cbegin()), other);
+	check(contents(values) == std::vector<int>{ 1, 4, 5, 2, 3 } && values.size() == 5 && consistent(values), "splice(pos, oth) inserts before pos");
+	check(other.empty() && other.size() == 0 && other.begin() == other.end(), "splice(pos, oth) empties oth");
+
+	other.push_back(6); /* У опустошенного списка должны быть сброшены head и tail */
+	values.splice(values.cend(), other);
+	check(contents(values) == std::vector<int>{ 1, 4, 5, 2, 3, 6 }, "splice at end() appends");
+
+	list<int> empty;
+	values.splice(values.cbegin(), empty);
+	check(values.size() == 6 && empty.empty(), "splice of an empty list changes nothing");
+
+	values.splice(values.cbegin(), values);
+	check(contents(values) == std::vector<int>{ 1, 4, 5, 2, 3, 6 } && values.size() == 6, "splice of a list into itself changes nothing");
+
+	empty.splice(empty.cend(), values);
+	check(empty.size() == 6 && values.empty() && consistent(empty), "splice into an empty list moves every node");
+	check(drainBackwards(empty) == std::vector<int>{ 1, 4, 5, 2, 3, 6 }, "splice keeps backward links");
+}
+
+static void testSpliceOne()
+{
+	list<int> values = makeList({ 1, 2, 3 });
+	list<int> other = makeList({ 4 });
+	values.splice(values.cbegin(), other, other.cbegin());
+	check(contents(values) == std::vector<int>{ 4, 1, 2, 3 } && values.size() == 4, "splice(pos, oth, it) moves one node");
+	check(other.empty() && other.size() == 0, "splice of the only node empties oth");
+	other.push_back(7);
+	check(contents(other) == std::vector<int>{ 7 }, "list is usable after losing its only node");
+
+	auto last = std::next(values.cbegin(), 3);
+	values.splice(values.cbegin(), values, last);
+	check(contents(values) == std::vector<int>{ 3, 4, 1, 2 } && values.size() == 4 && consistent(values), "splice of own last node to the front");
+
+	values.splice(values.cend(), values, values.cbegin());
+	check(contents(values) == std::vector<int>{ 4, 1, 2, 3 } && values.size() == 4, "splice of own first node to the end");
+
+	auto second = std::next(values.cbegin());
+	values.splice(second, values, second);
+	values.splice(std::next(second), values, second);
+	check(contents(values) == std::vector<int>{ 4, 1, 2, 3 } && values.size() == 4, "splice of a node onto its own place changes nothing");
+	check(drainBackwards(values) == std::vector<int>{ 4, 1, 2, 3 }, "single-node splice keeps backward links");
+}
+
+static void testMerge()
+{
+	list<int> values = makeList({ 1, 3, 5 });
+	list<int> other = makeList({ 2, 3, 4, 6, 7 });
+	values.merge(other);
+	check(contents(values) == std::vector<int>{ 1, 2, 3, 3, 4, 5, 6, 7 } && values.size() == 8, "merge interleaves sorted lists");
+	check(other.empty() && other.size() == 0, "merge empties oth");
+
+	list<int> empty;
+	values.merge(empty);
+	check(values.size() == 8 && empty.empty(), "merge of an empty list changes nothing");
+	values.merge(values);
+	check(values.size() == 8 && consistent(values), "merge of a list with itself changes nothing");
+	empty.merge(values);
+	check(contents(empty) == std::vector<int>{ 1, 2, 3, 3, 4, 5, 6, 7 } && values.empty(), "merge into an empty list takes every node");
+	check(drainBackwards(empty) == std::vector<int>{ 1, 2, 3, 3, 4, 5, 6, 7 }, "merge keeps backward links");
+
+	/* При равных ключах узлы *this идут раньше узлов oth */
+	list<Keyed> left, right;
+	for (int i = 0; i < 4; ++i)
+	{
+		left.push_back(Keyed{ i / 2, i });
+		right.push_back(Keyed{ i / 2, 10 + i });
+	}
+	left.merge(right, keyLess);
+	std::vector<int> orders;
+	for (const Keyed& value : left)
+		orders.push_back(value.order);
+	check(orders == std::vector<int>{ 0, 1, 10, 11, 2, 3, 12, 13 }, "merge is stable");
+}
+
+static void testSort()
+{
+	list<int> empty;
+	empty.sort();
+	check(empty.empty() && empty.size() == 0, "sort of an empty list");
+
+	list<int> single = makeList({ 42 });
+	single.sort();
+	check(contents(single) == std::vector<int>{ 42 } && single.size() == 1, "sort of a single element");
+
+	/* Псевдослучайные ключи с повторами против std::stable_sort */
+	list<Keyed> values;
+	std::vector<Keyed> expected;
+	unsigned seed = 12345;
+	for (int i = 0; i < 1000; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		values.push_back(Keyed{ static_cast<int>((seed >> 16) % 50), i });
+		expected.push_back(values.back());
+	}
+	values.sort(keyLess);
+	std::stable_sort(expected.begin(), expected.end(), keyLess);
+	bool same = values.size() == expected.size() && consistent(values);
+	auto it = values.begin();
+	for (std::size_t i = 0; same && i < expected.size(); ++i, ++it)
+		same = it->key == expected[i].key && it->order == expected[i].order;
+	check(same, "sort matches std::stable_sort, equal keys keep their order");
+
+	list<int> reversed;
+	for (int i = 100; i > 0; --i)
+		reversed.push_back(i);
+	reversed.sort();
+	std::vector<int> ascending(100);
+	for (int i = 0; i < 100; ++i)
+		ascending[i] = i + 1;
+	check(reversed.size() == 100 && drainBackwards(reversed) == ascending, "sort keeps backward links");
+}
+
+
+int main()
+{
+	testSizeConstructor();
+	testCopyConstructor();
+	testCopyAssignment();
+	testPushBack();
+	testPushRange();
+	testSpliceAll();
+	testSpliceOne();
+	testMerge();
+	testSort();
+	check(Tracked::live == 0, "no live elements at exit");
+
+	if (failures)
+		return 1;
+	std::cout << "list_test: OK\n";
+	return 0;
+}
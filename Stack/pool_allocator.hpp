@@ -0,0 +1,244 @@
+﻿#ifndef _pool_allocator_hpp
+#define _pool_allocator_hpp
+
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/*
+*  Набор пулов ячеек фиксированного размера, общий для копий и rebind-копий одного pool_allocator.
+*  Память берется у системы чанками по ChunkSize ячеек, одиночные аллокации
+*  нарезаются из текущего чанка, освобожденные ячейки попадают в свободный список
+*  и переиспользуются. Чанки возвращаются системе только при уничтожении набора.
+*  На каждый размер ячейки свой пул, поэтому allocator<int> и его rebind<Node> берут узлы
+*  из одного набора, но ячейки разных размеров не смешиваются.
+*/
+template<std::size_t ChunkSize>
+class pool_registry final
+{
+public:
+	/* Пул ячеек одного размера */
+	class pool final
+	{
+	public:
+		explicit pool(std::size_t slot_size) noexcept;
+		~pool();
+
+		pool(const pool& oth) = delete;
+		pool& operator=(const pool& oth) = delete;
+
+		std::size_t slot_size() const noexcept;
+		void* allocate();
+		void deallocate(void* ptr) noexcept;
+	private:
+		/* Свободная ячейка хранит указатель на следующую */
+		struct Free final
+		{
+			Free* next;
+		};
+
+		const std::size_t size;
+		std::vector<unsigned char*> chunks{}; /* Все выделенные чанки */
+		Free* free_list = nullptr; /* Освобожденные ячейки */
+		unsigned char* cursor = nullptr; /* Следующая ненарезанная ячейка текущего чанка */
+		unsigned char* chunk_end = nullptr;
+	};
+
+	pool_registry() = default;
+	~pool_registry() = default;
+
+	pool_registry(const pool_registry& oth) = delete;
+	pool_registry& operator=(const pool_registry& oth) = delete;
+
+	pool& get(std::size_t slot_size); /* Пул ячеек размера slot_size, создается при первом запросе */
+private:
+	std::vector<std::unique_ptr<pool>> pools{}; /* Обычно один-два размера, линейный поиск дешевле словаря */
+};
+
+
+/*
+*  "Stdlike" аллокатор с пулом узлов фиксированного размера.
+*  Предназначен для list: одиночные аллокации узлов идут в пул pool_registry,
+*  аллокации больше одного объекта - в обход пула через operator new.
+*  Копии и rebind-копии аллокатора разделяют один набор пулов, поэтому сравниваются как равные
+*  (A(B(a)) == a), и list с аллокаторами из одного источника перевязывает узлы друг друга.
+*/
+template<typename Type, std::size_t ChunkSize = 1024>
+class pool_allocator final
+{
+	static_assert(ChunkSize > 0, "pool_allocator requires non-zero chunk size");
+	static_assert(alignof(Type) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "pool_allocator does not support over-aligned types");
+
+	template<typename Other, std::size_t OtherChunkSize>
+	friend class pool_allocator;
+public:
+	/* Типы */
+	using value_type = Type;
+	using pointer = Type*;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	/* Копии аллокатора разделяют пул, поэтому его можно передавать вместе с контейнером */
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	template<typename Other>
+	struct rebind
+	{
+		using other = pool_allocator<Other, ChunkSize>;
+	};
+
+	/* Конструкторы и деструктор */
+	pool_allocator();
+	pool_allocator(const pool_allocator& oth) noexcept;
+	template<typename Other>
+	pool_allocator(const pool_allocator<Other, ChunkSize>& oth); /* Тот же набор пулов, ячейки своего размера */
+	~pool_allocator() = default;
+
+	/* Операторы */
+	pool_allocator& operator=(const pool_allocator& oth) noexcept;
+	bool operator==(const pool_allocator& oth) const noexcept;
+	bool operator!=(const pool_allocator& oth) const noexcept;
+	/* Методы */
+	Type* allocate(std::size_t count); /* Выделяет память под count объектов */
+	void deallocate(Type* ptr, std::size_t count) noexcept; /* Возвращает память в пул */
+private:
+	using registry_type = pool_registry<ChunkSize>;
+
+	/* Ячейка вмещает объект или указатель свободного списка и кратна выравниванию обоих,
+	*  поэтому типы с одинаковым slot_size могут делить один пул */
+	static constexpr std::size_t slot_alignment = alignof(Type) > alignof(void*) ? alignof(Type) : alignof(void*);
+	static constexpr std::size_t slot_size = ((sizeof(Type) > sizeof(void*) ? sizeof(Type) : sizeof(void*)) + slot_alignment - 1)
+		/ slot_alignment * slot_alignment;
+
+	std::shared_ptr<registry_type> registry;
+	typename registry_type::pool* pool_ptr; /* Пул ячеек slot_size внутри registry */
+};
+
+
+template<std::size_t ChunkSize>
+pool_registry<ChunkSize>::pool::pool(std::size_t slot_size) noexcept
+	: size(slot_size)
+{}
+
+template<std::size_t ChunkSize>
+pool_registry<ChunkSize>::pool::~pool()
+{
+	for (unsigned char* chunk : chunks)
+		::operator delete(chunk);
+}
+
+template<std::size_t ChunkSize>
+std::size_t pool_registry<ChunkSize>::pool::slot_size() const noexcept
+{
+	return size;
+}
+
+template<std::size_t ChunkSize>
+void* pool_registry<ChunkSize>::pool::allocate()
+{
+	Free* slot = free_list;
+	if (slot) /* Сначала переиспользуем освобожденные ячейки */
+	{
+		free_list = slot->next;
+		return slot;
+	}
+
+	if (cursor == chunk_end) /* Текущий чанк закончился - берем новый */
+	{
+		chunks.reserve(chunks.size() + 1); /* Резервируем заранее, чтобы не потерять чанк при исключении */
+		unsigned char* chunk = static_cast<unsigned char*>(::operator new(size * ChunkSize));
+		chunks.push_back(chunk);
+		cursor = chunk;
+		chunk_end = chunk + size * ChunkSize;
+	}
+
+	void* result = cursor;
+	cursor += size;
+	return result;
+}
+
+template<std::size_t ChunkSize>
+void pool_registry<ChunkSize>::pool::deallocate(void* ptr) noexcept
+{
+	Free* slot = ::new(ptr) Free{ free_list };
+	free_list = slot;
+}
+
+template<std::size_t ChunkSize>
+typename pool_registry<ChunkSize>::pool& pool_registry<ChunkSize>::get(std::size_t slot_size)
+{
+	for (auto& item : pools)
+		if (item->slot_size() == slot_size)
+			return *item;
+
+	pools.reserve(pools.size() + 1);
+	pools.push_back(std::make_unique<pool>(slot_size));
+	return *pools.back();
+}
+
+
+template<typename Type, std::size_t ChunkSize>
+pool_allocator<Type, ChunkSize>::pool_allocator()
+	: registry(std::make_shared<registry_type>()),
+	pool_ptr(&registry->get(slot_size))
+{}
+
+template<typename Type, std::size_t ChunkSize>
+pool_allocator<Type, ChunkSize>::pool_allocator(const pool_allocator& oth) noexcept
+	: registry(oth.registry),
+	pool_ptr(oth.pool_ptr)
+{}
+
+template<typename Type, std::size_t ChunkSize>
+template<typename Other>
+pool_allocator<Type, ChunkSize>::pool_allocator(const pool_allocator<Other, ChunkSize>& oth)
+	: registry(oth.registry),
+	pool_ptr(&registry->get(slot_size))
+{}
+
+
+template<typename Type, std::size_t ChunkSize>
+pool_allocator<Type, ChunkSize>& pool_allocator<Type, ChunkSize>::operator=(const pool_allocator& oth) noexcept
+{
+	registry = oth.registry;
+	pool_ptr = oth.pool_ptr;
+	return *this;
+}
+
+template<typename Type, std::size_t ChunkSize>
+bool pool_allocator<Type, ChunkSize>::operator==(const pool_allocator& oth) const noexcept
+{
+	return registry == oth.registry;
+}
+
+template<typename Type, std::size_t ChunkSize>
+bool pool_allocator<Type, ChunkSize>::operator!=(const pool_allocator& oth) const noexcept
+{
+	return registry != oth.registry;
+}
+
+template<typename Type, std::size_t ChunkSize>
+Type* pool_allocator<Type, ChunkSize>::allocate(std::size_t count)
+{
+	if (count == 1)
+		return static_cast<Type*>(pool_ptr->allocate());
+	else /* Массивы в пул не помещаются */
+		return static_cast<Type*>(::operator new(sizeof(Type) * count));
+}
+
+template<typename Type, std::size_t ChunkSize>
+void pool_allocator<Type, ChunkSize>::deallocate(Type* ptr, std::size_t count) noexcept
+{
+	if (count == 1)
+		pool_ptr->deallocate(ptr);
+	else
+		::operator delete(ptr);
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,440 @@
+﻿#ifndef _small_stack_hpp
+#define _small_stack_hpp
+
+
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include "stack.hpp"
+
+/*
+*  Однопоточный вектор с "small buffer optimization" и поддержкой пользовательского "stdlike" аллокатора.
+*  Первые N элементов хранятся прямо в объекте, в кучу уходим только при переполнении.
+*  Элементы конструируются лениво, конструктор по умолчанию у типа не требуется.
+*  Реализованы методы, нужные stack, поэтому используется как его Container (см. small_stack ниже).
+*/
+template<typename Type, std::size_t N, typename Alloc = std::allocator<Type>>
+class small_vector final
+{
+	static_assert(N > 0, "small_vector requires non-zero inline capacity");
+public:
+	/* Типы */
+	using value_type = Type;
+	using pointer = Type*;
+	using reference = Type&;
+	using iterator = Type*;
+	using const_iterator = const Type*;
+	/* Конструкторы и деструктор */
+	explicit small_vector(const Alloc& alloc = Alloc());
+	small_vector(const small_vector& oth);
+	small_vector(small_vector&& oth) noexcept(std::is_nothrow_move_constructible_v<Type>);
+	~small_vector();
+
+	/* Операторы */
+	small_vector& operator=(const small_vector& oth) &;
+	small_vector& operator=(small_vector&& oth) & noexcept(std::is_nothrow_move_constructible_v<Type>
+		&& (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value || std::allocator_traits<Alloc>::is_always_equal::value)); /* При неравных аллокаторах без распространения - поэлементно */
+	Type& operator[](std::size_t index) noexcept;
+	const Type& operator[](std::size_t index) const noexcept;
+	/* Методы */
+	Type& back(); /* Возвращает ссылку на последний элемент */
+	const Type& back() const; /* Возвращает константную ссылку на последний элемент */
+
+	bool empty() const noexcept; /* Если контейнер пустой, возвращает true, иначе false */
+	std::size_t size() const noexcept; /* Возвращает размер контейнера */
+	std::size_t capacity() const noexcept; /* Возвращает вместимость без переаллокации */
+	bool is_inline() const noexcept; /* true, если элементы лежат во встроенном буфере */
+	void clear() noexcept; /* Чистит контейнер, память в куче сохраняется */
+	void reserve(std::size_t new_capacity); /* Гарантирует вместимость не меньше new_capacity */
+
+	void push_back(const Type& value); /* Кладет lvalue значение в конец */
+	void push_back(Type&& value); /* Кладет rvalue* значение в конец */
+
+	template<typename... Args>
+	void emplace_back(Args&&... args); /* Создает в конце элемент от входящих аргументов */
+
+	void pop_back() noexcept; /* Удаляет элемент из конца */
+
+	/* Методы для работы с итераторами */
+	iterator begin() noexcept;
+	const_iterator begin() const noexcept;
+	iterator end() noexcept;
+	const_iterator end() const noexcept;
+	const_iterator cbegin() const noexcept;
+	const_iterator cend() const noexcept;
+private:
+	using AllocTraits = std::allocator_traits<Alloc>;
+
+	Type* inline_data() noexcept;
+	void release_heap() noexcept; /* Отдает память кучи и возвращается во встроенный буфер */
+	void steal(small_vector&& oth) noexcept(std::is_nothrow_move_constructible_v<Type>); /* Забирает содержимое oth, сам должен быть пустым; при исключении остается пустым */
+	template<typename... Args>
+	void grow_and_emplace(Args&&... args); /* Переезд в буфер вдвое больше с добавлением элемента */
+
+	/* Поля */
+	alignas(Type) unsigned char buffer[sizeof(Type) * N];
+	Type* data = inline_data();
+	std::size_t count = 0;
+	std::size_t cap = N;
+	Alloc alloc{};
+};
+
+/* Стек, который до N элементов не трогает кучу */
+template<typename Type, std::size_t N = 32>
+using small_stack = stack<Type, small_vector<Type, N>>;
+
+
+template<typename Type, std::size_t N, typename Alloc>
+small_vector<Type, N, Alloc>::small_vector(const Alloc& alloc)
+	: alloc(alloc)
+{}
+
+template<typename Type, std::size_t N, typename Alloc>
+small_vector<Type, N, Alloc>::small_vector(const small_vector& oth)
+/* Если аллокатор не переопределил select_on_cont.... То возвращаем то же аллокатор */
+	: small_vector(AllocTraits::select_on_container_copy_construction(oth.alloc))
+{
+	reserve(oth.count);
+	try
+	{
+		for (; count < oth.count; ++count)
+			AllocTraits::construct(alloc, data + count, oth.data[count]);
+	}
+	catch (...)
+	{
+		clear();
+		release_heap();
+		throw;
+	}
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+small_vector<Type, N, Alloc>::small_vector(small_vector&& oth) noexcept(std::is_nothrow_move_constructible_v<Type>)
+	: alloc(std::move(oth.alloc))
+{
+	steal(std::move(oth));
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+small_vector<Type, N, Alloc>::~small_vector()
+{
+	clear();
+	release_heap();
+}
+
+
+template<typename Type, std::size_t N, typename Alloc>
+small_vector<Type, N, Alloc>& small_vector<Type, N, Alloc>::operator=(const small_vector& oth) &
+{
+	if (this == std::addressof(oth))
+		return *this;
+
+	clear();
+	/* Определяем, должны ли мы создавать копию пула аллокатора, или просто копию без нового пула */
+	if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+		if (alloc != oth.alloc)
+		{
+			release_heap(); /* Память кучи принадлежит старому аллокатору */
+			alloc = oth.alloc;
+		}
+
+	reserve(oth.count);
+	try
+	{
+		for (; count < oth.count; ++count)
+			AllocTraits::construct(alloc, data + count, oth.data[count]);
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+	return *this;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+small_vector<Type, N, Alloc>& small_vector<Type, N, Alloc>::operator=(small_vector&& oth) & noexcept(std::is_nothrow_move_constructible_v<Type>
+		&& (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value || std::allocator_traits<Alloc>::is_always_equal::value))
+{
+	if (this == std::addressof(oth))
+		return *this;
+
+	clear();
+	release_heap();
+	/* То же самое, что и в operator=, только сейчас муваем */
+	if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+	{
+		if (alloc != oth.alloc)
+			alloc = std::move(oth.alloc);
+	}
+	else if (alloc != oth.alloc)
+	{ /* Буфер кучи oth принадлежит чужому ресурсу - перемещаем элементы в свой буфер */
+		reserve(oth.count);
+		try
+		{
+			for (; count < oth.count; ++count)
+				AllocTraits::construct(alloc, data + count, std::move(oth.data[count]));
+		}
+		catch (...)
+		{
+			clear();
+			throw;
+		}
+		oth.clear();
+		return *this;
+	}
+
+	steal(std::move(oth));
+	return *this;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+Type& small_vector<Type, N, Alloc>::operator[](std::size_t index) noexcept
+{
+	return data[index];
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+const Type& small_vector<Type, N, Alloc>::operator[](std::size_t index) const noexcept
+{
+	return data[index];
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+Type& small_vector<Type, N, Alloc>::back()
+{
+	if (count)
+		return data[count - 1];
+	else
+		throw std::runtime_error("Stack is empty!\n"); /* Если запрашиваем элемент из пустого контейнера */
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+const Type& small_vector<Type, N, Alloc>::back() const
+{
+	if (count)
+		return data[count - 1];
+	else
+		throw std::runtime_error("Stack is empty!\n"); /* Если запрашиваем элемент из пустого контейнера */
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+bool small_vector<Type, N, Alloc>::empty() const noexcept
+{
+	return count == 0;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+std::size_t small_vector<Type, N, Alloc>::size() const noexcept
+{
+	return count;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+std::size_t small_vector<Type, N, Alloc>::capacity() const noexcept
+{
+	return cap;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+bool small_vector<Type, N, Alloc>::is_inline() const noexcept
+{
+	return data == reinterpret_cast<const Type*>(buffer);
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+void small_vector<Type, N, Alloc>::clear() noexcept
+{
+	for (; count; --count)
+		AllocTraits::destroy(alloc, data + count - 1);
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+void small_vector<Type, N, Alloc>::reserve(std::size_t new_capacity)
+{
+	if (new_capacity <= cap)
+		return;
+
+	Type* temp = AllocTraits::allocate(alloc, new_capacity);
+	std::size_t counter = 0; /* Счетчик перенесенных элементов */
+	try
+	{
+		for (; counter < count; ++counter)
+			AllocTraits::construct(alloc, temp + counter, std::move_if_noexcept(data[counter]));
+	}
+	catch (...)
+	{ /* Старый буфер не тронут, если перенос копирующий */
+		for (std::size_t i = 0; i < counter; ++i)
+			AllocTraits::destroy(alloc, temp + i);
+		AllocTraits::deallocate(alloc, temp, new_capacity);
+		throw;
+	}
+
+	std::size_t size = count;
+	clear();
+	release_heap();
+	data = temp;
+	count = size;
+	cap = new_capacity;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+void small_vector<Type, N, Alloc>::push_back(const Type& value)
+{
+	emplace_back(value);
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+void small_vector<Type, N, Alloc>::push_back(Type&& value)
+{
+	emplace_back(std::move(value));
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+template<typename... Args>
+void small_vector<Type, N, Alloc>::emplace_back(Args&&... args)
+{
+	if (count == cap) /* Места нет - переезжаем */
+	{
+		grow_and_emplace(std::forward<Args>(args)...);
+		return;
+	}
+
+	AllocTraits::construct(alloc, data + count, std::forward<Args>(args)...);
+	++count;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+void small_vector<Type, N, Alloc>::pop_back() noexcept
+{
+	if (empty())
+		return;
+
+	AllocTraits::destroy(alloc, data + --count);
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+typename small_vector<Type, N, Alloc>::iterator small_vector<Type, N, Alloc>::begin() noexcept
+{
+	return data;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+typename small_vector<Type, N, Alloc>::const_iterator small_vector<Type, N, Alloc>::begin() const noexcept
+{
+	return data;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+typename small_vector<Type, N, Alloc>::iterator small_vector<Type, N, Alloc>::end() noexcept
+{
+	return data + count;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+typename small_vector<Type, N, Alloc>::const_iterator small_vector<Type, N, Alloc>::end() const noexcept
+{
+	return data + count;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+typename small_vector<Type, N, Alloc>::const_iterator small_vector<Type, N, Alloc>::cbegin() const noexcept
+{
+	return begin();
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+typename small_vector<Type, N, Alloc>::const_iterator small_vector<Type, N, Alloc>::cend() const noexcept
+{
+	return end();
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+Type* small_vector<Type, N, Alloc>::inline_data() noexcept
+{
+	return reinterpret_cast<Type*>(buffer);
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+void small_vector<Type, N, Alloc>::release_heap() noexcept
+{
+	if (is_inline())
+		return;
+
+	AllocTraits::deallocate(alloc, data, cap);
+	data = inline_data();
+	cap = N;
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+void small_vector<Type, N, Alloc>::steal(small_vector&& oth) noexcept(std::is_nothrow_move_constructible_v<Type>)
+{
+	if (!oth.is_inline()) /* Буфер в куче просто забираем */
+	{
+		data = oth.data;
+		count = oth.count;
+		cap = oth.cap;
+		oth.data = oth.inline_data();
+		oth.count = 0;
+		oth.cap = N;
+		return;
+	}
+
+	/* Встроенный буфер переносим поэлементно; если перемещение бросит, уже перенесенные уничтожаем -
+	*  из конструктора деструктор не вызовется */
+	try
+	{
+		for (; count < oth.count; ++count)
+			AllocTraits::construct(alloc, data + count, std::move(oth.data[count]));
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+	oth.clear();
+}
+
+template<typename Type, std::size_t N, typename Alloc>
+template<typename... Args>
+void small_vector<Type, N, Alloc>::grow_and_emplace(Args&&... args)
+{
+	std::size_t new_capacity = cap * 2;
+	Type* temp = AllocTraits::allocate(alloc, new_capacity);
+	try
+	{ /* Новый элемент создаем первым: аргументы могут ссылаться на элементы старого буфера */
+		AllocTraits::construct(alloc, temp + count, std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		AllocTraits::deallocate(alloc, temp, new_capacity);
+		throw;
+	}
+
+	std::size_t counter = 0;
+	try
+	{
+		for (; counter < count; ++counter)
+			AllocTraits::construct(alloc, temp + counter, std::move_if_noexcept(data[counter]));
+	}
+	catch (...)
+	{
+		for (std::size_t i = 0; i < counter; ++i)
+			AllocTraits::destroy(alloc, temp + i);
+		AllocTraits::destroy(alloc, temp + count);
+		AllocTraits::deallocate(alloc, temp, new_capacity);
+		throw;
+	}
+
+	std::size_t size = count + 1;
+	clear();
+	release_heap();
+	data = temp;
+	count = size;
+	cap = new_capacity;
+}
+
+
+#endif
\ No newline at end of file
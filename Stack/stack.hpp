@@ -3,12 +3,41 @@
 
 
 #include <iostream>
+#include <algorithm>
 #include <deque>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <type_traits>
 #include <cassert>
 
 #include "EStackEmpty.hpp"
 
+
+/* Политики проверки пустоты для top() и pop(): check(empty) вызывается перед обращением к контейнеру */
+struct throw_on_empty final /* Кидает EStackEmpty */
+{
+	static void check(bool empty)
+	{
+		if (empty)
+			throw EStackEmpty();
+	}
+};
+
+struct assert_on_empty final /* assert в отладочной сборке, в релизе (NDEBUG) проверки нет */
+{
+	static void check([[maybe_unused]] bool empty) noexcept
+	{
+		assert(!empty && "Stack is empty!");
+	}
+};
+
+struct no_empty_check final /* Без проверки: top() и pop() пустого стека - неопределенное поведение контейнера */
+{
+	static constexpr void check(bool) noexcept {}
+};
+
+
 /* 
 *  Однопоточный адаптер для контейнера. По дефолту используется двусторонняя очередь.
 *  Аллокатор внутри контейнера должен быть "stdlke".
@@ -16,9 +45,13 @@
 *  back(),
 *  push_back(),
 *  pop_back().
+*  Если у контейнера есть append(Container&&) (как у list), append стека переносит элементы через него.
+*  push_range использует push_range контейнера, иначе insert в конец, иначе reserve и push_back.
 *  У элементов тип должен иметь конструктор по умолчанию и конструктор копированияю.
+*  Check - политика проверки пустоты в top() и pop(), выбирается при компиляции:
+*  throw_on_empty (по умолчанию), assert_on_empty или no_empty_check.
 */
-template<typename Type, typename Container = std::deque<Type>>
+template<typename Type, typename Container = std::deque<Type>, typename Check = throw_on_empty>
 class stack final
 {
 public:
@@ -31,16 +64,23 @@ public:
 
 	/* Конструкторы и деструктор */
 	stack() = default;
+	explicit stack(const Container& container); /* Стек поверх копии готового контейнера (например, с нужным аллокатором) */
+	explicit stack(Container&& container);
+	template<typename InputIt, typename = std::enable_if_t< /* Только итераторы, чтобы не перехватывать пары других аргументов */
+		std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+	stack(InputIt first, InputIt last); /* Стек из диапазона, last - вершина */
 	stack(const stack& oth);
 	stack(stack&& oth) noexcept;
 	~stack() = default;
 
 	/* Операторы */
 	stack& operator=(const stack& oth) &;
-	stack& operator=(stack&& oth) & noexcept;
+	stack& operator=(stack&& oth) & noexcept(std::is_nothrow_move_assignable_v<Container>);
 	/* Методы */
 	Type& top(); /* Возвращает ссылку на верхний элемент стека */
 	const Type& top() const; /* Возвращает константную ссылку на верхний элемент стека */
+	Type* try_top() noexcept; /* Указатель на верхний элемент или nullptr, если стек пустой */
+	const Type* try_top() const noexcept; /* Константный указатель на верхний элемент или nullptr */
 
 	bool empty() const noexcept; /* Если контейнер пустой, возвращает true, иначе false */
 	std::size_t size() const noexcept; /* Возвращает размер контейнера */
@@ -52,103 +92,258 @@ public:
 	void emplace(Args&&... args); /* Создает в вершине стека элемент от входящих аргументов */
 
 	void pop(); /* Удаляет верхний элемент */
+	std::optional<Type> try_pop(); /* Забирает верхний элемент; если стек пустой, возвращает nullopt без исключения */
+	bool try_pop(Type& value); /* Перемещает верхний элемент в value и удаляет его; false, если стек пустой */
+
+	template<typename InputIt>
+	void push_range(InputIt first, InputIt last); /* Кладет диапазон, последний элемент станет вершиной */
+	void pop_n(std::size_t n) noexcept; /* Удаляет до n верхних элементов */
+	template<typename OutputIt>
+	OutputIt pop_n(std::size_t n, OutputIt out); /* Перемещает до n верхних элементов в out, начиная с вершины */
+	template<typename OutputIt>
+	OutputIt drain_into(OutputIt out); /* Перемещает в out все элементы, начиная с вершины */
+
+	void append(stack&& oth); /* Кладет весь oth поверх стека в том же порядке, oth становится пустым */
+	void swap(stack& oth) noexcept(std::is_nothrow_swappable_v<Container>); /* Обменивается содержимым с oth */
 
 	const Container& getContainer() const noexcept;
 private:
 
+	/* Есть ли у контейнера перенос целиком: append(Container&&) */
+	template<typename Cont, typename = void>
+	struct has_append : std::false_type {};
+	template<typename Cont>
+	struct has_append<Cont, std::void_t<decltype(std::declval<Cont&>().append(std::declval<Cont&&>()))>> : std::true_type {};
+	/* Есть ли у контейнера вставка диапазона: push_range(first, last) или insert(end(), first, last) */
+	template<typename Cont, typename It, typename = void>
+	struct has_push_range : std::false_type {};
+	template<typename Cont, typename It>
+	struct has_push_range<Cont, It, std::void_t<decltype(std::declval<Cont&>().push_range(std::declval<It>(), std::declval<It>()))>> : std::true_type {};
+	template<typename Cont, typename It, typename = void>
+	struct has_insert : std::false_type {};
+	template<typename Cont, typename It>
+	struct has_insert<Cont, It, std::void_t<decltype(std::declval<Cont&>().insert(std::declval<Cont&>().end(), std::declval<It>(), std::declval<It>()))>> : std::true_type {};
+	/* Есть ли у контейнера reserve(n) */
+	template<typename Cont, typename = void>
+	struct has_reserve : std::false_type {};
+	template<typename Cont>
+	struct has_reserve<Cont, std::void_t<decltype(std::declval<Cont&>().reserve(std::size_t()))>> : std::true_type {};
+
 	Container container{};
 };
 
 
-template<typename Type, typename Container>
-stack<Type, Container>::stack(const stack& oth)
+template<typename Type, typename Container, typename Check>
+stack<Type, Container, Check>::stack(const Container& container)
+	: container(container)
+{}
+
+template<typename Type, typename Container, typename Check>
+stack<Type, Container, Check>::stack(Container&& container)
+	: container(std::move(container))
+{}
+
+template<typename Type, typename Container, typename Check>
+template<typename InputIt, typename>
+stack<Type, Container, Check>::stack(InputIt first, InputIt last)
+{
+	push_range(first, last);
+}
+
+template<typename Type, typename Container, typename Check>
+stack<Type, Container, Check>::stack(const stack& oth)
 	: container(oth.container)
 {}
 
-template<typename Type, typename Container>
-stack<Type, Container>::stack(stack&& oth) noexcept
+template<typename Type, typename Container, typename Check>
+stack<Type, Container, Check>::stack(stack&& oth) noexcept
 	: container(std::move(oth.container))
 {}
 
 
-template<typename Type, typename Container>
-stack<Type, Container>& stack<Type, Container>::operator=(const stack& oth) &
+template<typename Type, typename Container, typename Check>
+stack<Type, Container, Check>& stack<Type, Container, Check>::operator=(const stack& oth) &
 {
 	container = oth.container;
 	return *this;
 }
 
-template<typename Type, typename Container>
-stack<Type, Container>& stack<Type, Container>::operator=(stack&& oth) & noexcept
+template<typename Type, typename Container, typename Check>
+stack<Type, Container, Check>& stack<Type, Container, Check>::operator=(stack&& oth) & noexcept(std::is_nothrow_move_assignable_v<Container>)
 {
 	container = std::move(oth.container);
 	return *this;
 }
 
-template<typename Type, typename Container>
-Type& stack<Type, Container>::top()
+template<typename Type, typename Container, typename Check>
+Type& stack<Type, Container, Check>::top()
 {
-	if (container.empty())
-		throw EStackEmpty(); /* Если контейнер пустой - кидаем исключение */
-	else
-		return container.back();
+	Check::check(container.empty()); /* Если контейнер пустой - поступаем по политике */
+	return container.back();
 }
 
-template<typename Type, typename Container>
-const Type& stack<Type, Container>::top() const
+template<typename Type, typename Container, typename Check>
+const Type& stack<Type, Container, Check>::top() const
 {
-	if (container.empty())
-		throw EStackEmpty(); /* Если контейнер пустой - кидаем исключение */
-	else
-		return container.back();
+	Check::check(container.empty()); /* Если контейнер пустой - поступаем по политике */
+	return container.back();
+}
+
+template<typename Type, typename Container, typename Check>
+Type* stack<Type, Container, Check>::try_top() noexcept
+{
+	return container.empty() ? nullptr : std::addressof(container.back());
 }
 
+template<typename Type, typename Container, typename Check>
+const Type* stack<Type, Container, Check>::try_top() const noexcept
+{
+	return container.empty() ? nullptr : std::addressof(container.back());
+}
 
-template<typename Type, typename Container>
-bool stack<Type, Container>::empty() const noexcept
+
+template<typename Type, typename Container, typename Check>
+bool stack<Type, Container, Check>::empty() const noexcept
 {
 	return container.empty();
 }
 
-template<typename Type, typename Container>
-std::size_t stack<Type, Container>::size() const noexcept
+template<typename Type, typename Container, typename Check>
+std::size_t stack<Type, Container, Check>::size() const noexcept
 {
 	return container.size();
 }
 
-template<typename Type, typename Container>
-void stack<Type, Container>::push(const Type& value)
+template<typename Type, typename Container, typename Check>
+void stack<Type, Container, Check>::push(const Type& value)
 {
 	container.push_back(value);
 }
 
-template<typename Type, typename Container>
-void stack<Type, Container>::push(Type&& value)
+template<typename Type, typename Container, typename Check>
+void stack<Type, Container, Check>::push(Type&& value)
 {
 	container.push_back(std::move(value)); /* Вызываем push_back контейнера от "мувнутого" значения */
 }
 
-template<typename Type, typename Container>
+template<typename Type, typename Container, typename Check>
 template<typename... Args>
-void stack<Type, Container>::emplace(Args&&... args)
+void stack<Type, Container, Check>::emplace(Args&&... args)
 {
 	container.emplace_back(std::forward<Args>(args)...); /* Вызываем emplace_back контейнера от "форварднутых" аргументов */
 }
 
-template<typename Type, typename Container>
-void stack<Type, Container>::pop()
+template<typename Type, typename Container, typename Check>
+void stack<Type, Container, Check>::pop()
+{
+	Check::check(container.empty()); /* Если контейнер пустой - поступаем по политике */
+	container.pop_back();
+}
+
+template<typename Type, typename Container, typename Check>
+std::optional<Type> stack<Type, Container, Check>::try_pop()
+{
+	if (container.empty())
+		return std::nullopt;
+
+	std::optional<Type> value(std::move(container.back()));
+	container.pop_back();
+	return value;
+}
+
+template<typename Type, typename Container, typename Check>
+bool stack<Type, Container, Check>::try_pop(Type& value)
 {
 	if (container.empty())
-		throw EStackEmpty(); /* Если контейнер пустой - кидаем исключение */
+		return false;
+
+	value = std::move(container.back());
+	container.pop_back();
+	return true;
+}
+
+template<typename Type, typename Container, typename Check>
+template<typename InputIt>
+void stack<Type, Container, Check>::push_range(InputIt first, InputIt last)
+{
+	if constexpr (has_push_range<Container, InputIt>::value)
+		container.push_range(first, last); /* list собирает цепочку узлов и подвязывает ее за раз */
+	else if constexpr (has_insert<Container, InputIt>::value)
+		container.insert(container.end(), first, last);
 	else
+	{
+		using category = typename std::iterator_traits<InputIt>::iterator_category;
+		if constexpr (has_reserve<Container>::value && std::is_base_of_v<std::forward_iterator_tag, category>)
+			container.reserve(container.size() + static_cast<std::size_t>(std::distance(first, last)));
+		for (; first != last; ++first)
+			container.push_back(*first);
+	}
+}
+
+template<typename Type, typename Container, typename Check>
+void stack<Type, Container, Check>::pop_n(std::size_t n) noexcept
+{
+	for (n = std::min(n, container.size()); n; --n) /* Пустоту проверяем один раз, а не на каждом элементе */
+		container.pop_back();
+}
+
+template<typename Type, typename Container, typename Check>
+template<typename OutputIt>
+OutputIt stack<Type, Container, Check>::pop_n(std::size_t n, OutputIt out)
+{
+	for (n = std::min(n, container.size()); n; --n)
+	{
+		*out = std::move(container.back());
+		++out;
 		container.pop_back();
+	}
+	return out;
+}
+
+template<typename Type, typename Container, typename Check>
+template<typename OutputIt>
+OutputIt stack<Type, Container, Check>::drain_into(OutputIt out)
+{
+	return pop_n(container.size(), out);
+}
+
+template<typename Type, typename Container, typename Check>
+void stack<Type, Container, Check>::append(stack&& oth)
+{
+	if (this == std::addressof(oth))
+		return;
+
+	if constexpr (has_append<Container>::value)
+		container.append(std::move(oth.container)); /* list перевязывает узлы за O(1) */
+	else
+	{
+		if (container.empty())
+			container = std::move(oth.container);
+		else
+			for (auto& value : oth.container)
+				container.push_back(std::move(value));
+		oth.container.clear(); /* После перемещения контейнер в неопределенном состоянии */
+	}
+}
+
+template<typename Type, typename Container, typename Check>
+void stack<Type, Container, Check>::swap(stack& oth) noexcept(std::is_nothrow_swappable_v<Container>)
+{
+	using std::swap;
+	swap(container, oth.container);
 }
 
-template<typename Type, typename Container>
-const Container& stack<Type, Container>::getContainer() const noexcept
+template<typename Type, typename Container, typename Check>
+const Container& stack<Type, Container, Check>::getContainer() const noexcept
 {
 	return container;
 }
 
+template<typename Type, typename Container, typename Check>
+void swap(stack<Type, Container, Check>& left, stack<Type, Container, Check>& right) noexcept(noexcept(left.swap(right)))
+{
+	left.swap(right);
+}
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+﻿#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "stack.hpp"
+#include "list.hpp"
+#include "small_stack.hpp"
+
+/*
+*  Проверка push_range и конструктора стека из диапазона на разных контейнерах:
+*  std::deque (insert в конец), small_vector (reserve и push_back, с переходом из встроенного буфера в кучу),
+*  list (собственный push_range). Диапазоны - прямые итераторы и однопроходные istream_iterator.
+*  Отдельно - перемещение small_vector со встроенным буфером, когда перемещение элемента бросает.
+*      g++ -std=c++17 -fsanitize=address,undefined stack_test.cpp -o stack_test
+*/
+
+
+/* Конструктор из диапазона принимает только итераторы */
+static_assert(std::is_constructible_v<stack<int>, const int*, const int*>, "stack is constructible from a pointer range");
+static_assert(std::is_constructible_v<stack<int>, std::list<int>::iterator, std::list<int>::iterator>, "stack is constructible from an iterator range");
+static_assert(!std::is_constructible_v<stack<int>, int, int>, "two ints are not an iterator range");
+static_assert(!std::is_constructible_v<stack<std::size_t>, std::size_t, std::size_t>, "two sizes are not an iterator range");
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+}
+
+/* Снимает все элементы, начиная с вершины */
+template<typename Stack>
+static std::vector<int> popAll(Stack& values)
+{
+	std::vector<int> result;
+	while (!values.empty())
+	{
+		result.push_back(values.top());
+		values.pop();
+	}
+	return result;
+}
+
+template<typename Container>
+static void testPushRange(const char* name)
+{
+	const std::vector<int> source{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+	stack<int, Container> values;
+	values.push(0);
+	values.push_range(source.begin(), source.end());
+	check(values.size() == 11 && values.top() == 10, name);
+	check(popAll(values) == std::vector<int>{ 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 }, name);
+
+	values.push_range(source.begin(), source.begin()); /* Пустой диапазон */
+	check(values.empty() && values.size() == 0, name);
+
+	std::istringstream text("4 5 6");
+	values.push(3);
+	values.push_range(std::istream_iterator<int>(text), std::istream_iterator<int>()); /* Однопроходный диапазон */
+	check(popAll(values) == std::vector<int>{ 6, 5, 4, 3 }, name);
+
+	stack<int, Container> built(source.begin(), source.end());
+	check(built.size() == source.size() && built.top() == 10, name);
+	check(popAll(built) == std::vector<int>{ 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 }, name);
+}
+
+static void testSmallVectorSpill()
+{
+	small_stack<int, 4> values;
+	const std::vector<int> first{ 1, 2, 3 };
+	values.push_range(first.begin(), first.end());
+	check(values.getContainer().is_inline(), "push_range within the inline buffer stays inline");
+
+	std::vector<int> second;
+	for (int i = 4; i <= 40; ++i)
+		second.push_back(i);
+	values.push_range(second.begin(), second.end());
+	check(!values.getContainer().is_inline() && values.size() == 40, "push_range past the inline buffer moves to the heap");
+
+	std::vector<int> expected;
+	for (int i = 40; i >= 1; --i)
+		expected.push_back(i);
+	check(popAll(values) == expected, "push_range across the spill keeps the order");
+}
+
+/* Элемент, перемещение которого бросает на заданном по счету перемещении */
+struct ThrowingMove final
+{
+	static inline int live = 0; /* Живые экземпляры */
+	static inline int moves_left = -1; /* Сколько перемещений еще разрешено, -1 - без ограничений */
+
+	int value = 0;
+
+	explicit ThrowingMove(int value) : value(value) { ++live; }
+	ThrowingMove(const ThrowingMove& oth) : value(oth.value) { ++live; }
+	ThrowingMove(ThrowingMove&& oth) : value(oth.value)
+	{
+		if (moves_left == 0)
+			throw std::runtime_error("ThrowingMove move failed\n");
+		if (moves_left > 0)
+			--moves_left;
+		++live;
+	}
+	~ThrowingMove() { --live; }
+	ThrowingMove& operator=(const ThrowingMove& oth) = default;
+};
+
+static void testSmallVectorMoveThrows()
+{
+	{
+		small_vector<ThrowingMove, 4> source;
+		for (int i = 0; i < 3; ++i)
+			source.emplace_back(i);
+
+		bool thrown = false;
+		ThrowingMove::moves_left = 1; /* Первый элемент переносится, второй бросает */
+		try
+		{
+			small_vector<ThrowingMove, 4> moved(std::move(source));
+		}
+		catch (const std::runtime_error&)
+		{
+			thrown = true;
+		}
+		ThrowingMove::moves_left = -1;
+		check(thrown, "small_vector move constructor throws");
+		check(ThrowingMove::live == 3, "failed small_vector move leaves only the source elements alive");
+		check(source.size() == 3 && source[2].value == 2, "failed small_vector move leaves the source intact");
+
+		small_vector<ThrowingMove, 4> target;
+		target.emplace_back(7);
+		ThrowingMove::moves_left = 2;
+		try
+		{
+			target = std::move(source);
+		}
+		catch (const std::runtime_error&)
+		{}
+		ThrowingMove::moves_left = -1;
+		check(target.empty() && ThrowingMove::live == 3, "failed small_vector move assignment leaves the target empty");
+	}
+	check(ThrowingMove::live == 0, "no ThrowingMove elements leak");
+}
+
+
+int main()
+{
+	testPushRange<std::deque<int>>("push_range on std::deque");
+	testPushRange<small_vector<int, 4>>("push_range on small_vector");
+	testPushRange<list<int>>("push_range on list");
+	testSmallVectorSpill();
+	testSmallVectorMoveThrows();
+
+	if (failures)
+		return 1;
+	std::cout << "stack_test: OK\n";
+	return 0;
+}
@@ -0,0 +1,498 @@
+﻿#ifndef _unrolled_list_hpp
+#define _unrolled_list_hpp
+
+
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+/*
+*  Однопоточный "развернутый" список с поддержкой пользовательского "stdlike" аллокатора.
+*  Каждый узел хранит до ChunkSize элементов подряд, поэтому на маленьких типах
+*  накладные расходы на указатели делятся на весь чанк, а обход идет по непрерывной памяти.
+*  Элементы конструируются лениво, конструктор по умолчанию у типа не требуется.
+*  Один опустевший узел кэшируется, чтобы push/pop на границе чанка не гоняли аллокатор.
+*  Вставка и удаление только с конца, поэтому подходит как Container для stack.
+*  Отсутствует reverse-iterator.
+*/
+template<typename Type, std::size_t ChunkSize = 16, typename Alloc = std::allocator<Type>>
+class unrolled_list final
+{
+	static_assert(ChunkSize > 0, "unrolled_list requires non-zero chunk size");
+public:
+	/* Типы */
+	using value_type = Type;
+	using pointer = Type*;
+	using reference = Type&;
+	/* Конструкторы и деструктор */
+	explicit unrolled_list(const Alloc& alloc = Alloc());
+	unrolled_list(const unrolled_list& oth);
+	unrolled_list(unrolled_list&& oth) noexcept;
+	~unrolled_list();
+
+	/* Операторы */
+	unrolled_list& operator=(const unrolled_list& oth) &;
+	unrolled_list& operator=(unrolled_list&& oth) & noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value
+		|| std::allocator_traits<Alloc>::is_always_equal::value); /* При неравных аллокаторах без распространения - поэлементно */
+	/* Методы */
+	Type& front(); /* Возвращает ссылку на начало списка */
+	const Type& front() const; /* Возвращает константную ссылку на начало списка */
+	Type& back(); /* Возвращает ссылку на конец списка */
+	const Type& back() const; /* Возвращает константную ссылку на конец списка */
+
+	bool empty() const noexcept; /* Если контейнер пустой, возвращает true, иначе false */
+	std::size_t size() const noexcept; /* Возвращает размер контейнера */
+	void clear() noexcept; /* Чистит контейнер */
+
+	void push_back(const Type& value); /* Кладет lvalue значение в конец */
+	void push_back(Type&& value); /* Кладет rvalue* значение в конец */
+
+	template<typename... Args>
+	void emplace_back(Args&&... args); /* Создает в конце элемент от входящих аргументов */
+
+	void pop_back() noexcept; /* Удаляет элемент из конца */
+private:
+	/* Узел списка: сырая память под ChunkSize элементов, из которых первые count сконструированы */
+	struct Node final
+	{
+		alignas(Type) unsigned char storage[sizeof(Type) * ChunkSize];
+		std::size_t count = 0;
+		Node* prev = nullptr;
+		Node* next = nullptr;
+
+		Type* slot(std::size_t index) noexcept /* Место под элемент index; объекта там может еще не быть, только для construct */
+		{
+			return reinterpret_cast<Type*>(storage) + index;
+		}
+
+		Type* element(std::size_t index) noexcept /* Сконструированный элемент, index < count */
+		{
+			return std::launder(slot(index));
+		}
+
+		const Type* element(std::size_t index) const noexcept
+		{
+			return std::launder(reinterpret_cast<const Type*>(storage) + index);
+		}
+	};
+public:
+	/* Объявляем "ребайнднутый" тип аллокатора, который будет аллоцировать не Type, а Node */
+	using RebindAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+	/* Объявляем обертку для нашего типа */
+	using AllocTraits = typename std::allocator_traits<RebindAlloc>;
+
+	/* Итератор */
+	template<bool isConst> /* База итератора */
+	class base_iterator final
+	{
+	private:
+		/* Типы */
+		using curTRef = std::conditional_t<isConst, const Type&, Type&>;
+		using curTPtr = std::conditional_t<isConst, const Type*, Type*>;
+
+		Node* ptr = nullptr;
+		std::size_t index = 0; /* Позиция внутри узла */
+	public:
+		/* Типы */
+		using iterator_category = std::bidirectional_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = Type;
+		using reference = curTRef;
+		using pointer = curTPtr;
+
+		base_iterator(Node* ptr = nullptr, std::size_t index = 0) : ptr(ptr), index(index) {}
+		~base_iterator() = default;
+
+		/* Операторы */
+		bool operator!=(const base_iterator& another) const noexcept
+		{
+			return ptr != another.ptr || index != another.index;
+		}
+
+		bool operator==(const base_iterator& another) const noexcept
+		{
+			return ptr == another.ptr && index == another.index;
+		}
+
+		base_iterator& operator++()
+		{
+			if (ptr && ++index == ptr->count) /* Дошли до конца узла - переходим в следующий */
+			{
+				ptr = ptr->next;
+				index = 0;
+			}
+
+			return *this;
+		}
+
+		base_iterator& operator--()
+		{
+			if (!ptr)
+				return *this;
+
+			if (index == 0) /* Начало узла - переходим в конец предыдущего */
+			{
+				ptr = ptr->prev;
+				index = ptr ? ptr->count - 1 : 0;
+			}
+			else
+				--index;
+
+			return *this;
+		}
+
+		base_iterator operator++(int) {
+			base_iterator copy = *this;
+			++(*this);
+			return copy;
+		}
+
+		base_iterator operator--(int) {
+			base_iterator copy = *this;
+			--(*this);
+			return copy;
+		}
+
+		curTRef operator*() const
+		{
+			return *ptr->element(index);
+		}
+
+		curTPtr operator->() const
+		{
+			return ptr->element(index);
+		}
+	};
+
+private:
+	/* Поля */
+	Node* head = nullptr;
+	Node* tail = nullptr;
+	Node* spare = nullptr; /* Закэшированный пустой узел */
+	std::size_t count = 0;
+	RebindAlloc rebind_alloc{};
+
+	Node* acquire_node(); /* Отдает закэшированный узел или аллоцирует новый */
+	void release_node(Node* node) noexcept; /* Кэширует узел, если кэш пуст, иначе освобождает */
+public:
+	/* Тип итератора */
+	using iterator = base_iterator<false>;
+	using const_iterator = base_iterator<true>;
+	/* Методы для работы с итераторами */
+	iterator begin()
+	{
+		return iterator(head);
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(head);
+	}
+
+	iterator end()
+	{
+		return iterator(nullptr);
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(nullptr);
+	}
+
+	const_iterator cbegin() const
+	{
+		return begin();
+	}
+
+	const_iterator cend() const
+	{
+		return end();
+	}
+};
+
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+unrolled_list<Type, ChunkSize, Alloc>::unrolled_list(const Alloc& alloc)
+	: rebind_alloc(alloc)
+{}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+unrolled_list<Type, ChunkSize, Alloc>::unrolled_list(const unrolled_list& oth)
+/* Если аллокатор не переопределил select_on_cont.... То возвращаем то же аллокатор */
+	: unrolled_list(std::allocator_traits<Alloc>::select_on_container_copy_construction(oth.rebind_alloc))
+{
+	try
+	{
+		for (const Type& value : oth)
+			push_back(value);
+	}
+	catch (...)
+	{ /* push_back сохраняет инварианты, поэтому достаточно почистить уже скопированное */
+		clear();
+		throw;
+	}
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+unrolled_list<Type, ChunkSize, Alloc>::unrolled_list(unrolled_list&& oth) noexcept
+	: head(oth.head),
+	tail(oth.tail),
+	spare(oth.spare),
+	count(oth.count),
+	rebind_alloc(std::move(oth.rebind_alloc))
+{
+	oth.head = nullptr;
+	oth.tail = nullptr;
+	oth.spare = nullptr;
+	oth.count = 0;
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+unrolled_list<Type, ChunkSize, Alloc>::~unrolled_list()
+{
+	clear();
+}
+
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+unrolled_list<Type, ChunkSize, Alloc>& unrolled_list<Type, ChunkSize, Alloc>::operator=(const unrolled_list& oth) &
+{
+	if (this == std::addressof(oth))
+		return *this;
+
+	clear();
+	/* Определяем, должны ли мы создавать копию пула аллокатора, или просто копию без нового пула */
+	if constexpr (std::allocator_traits<Alloc>::propagate_on_container_copy_assignment::value)
+		if (rebind_alloc != oth.rebind_alloc)
+			rebind_alloc = oth.rebind_alloc;
+
+	try
+	{
+		for (const Type& value : oth)
+			push_back(value);
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+	return *this;
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+unrolled_list<Type, ChunkSize, Alloc>& unrolled_list<Type, ChunkSize, Alloc>::operator=(unrolled_list&& oth) & noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value
+		|| std::allocator_traits<Alloc>::is_always_equal::value)
+{
+	if (this == std::addressof(oth))
+		return *this;
+
+	clear();
+	/* То же самое, что и в operator=, только сейчас муваем */
+	if constexpr (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value)
+	{
+		if (rebind_alloc != oth.rebind_alloc)
+			rebind_alloc = std::move(oth.rebind_alloc);
+	}
+	else if (rebind_alloc != oth.rebind_alloc)
+	{ /* Узлы oth принадлежат чужому ресурсу - перемещаем элементы в свои узлы */
+		try
+		{
+			for (Type& value : oth)
+				push_back(std::move(value));
+		}
+		catch (...)
+		{
+			clear();
+			throw;
+		}
+		oth.clear();
+		return *this;
+	}
+
+	head = oth.head;
+	oth.head = nullptr;
+	tail = oth.tail;
+	oth.tail = nullptr;
+	spare = oth.spare;
+	oth.spare = nullptr;
+	count = oth.count;
+	oth.count = 0;
+	return *this;
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+Type& unrolled_list<Type, ChunkSize, Alloc>::front()
+{
+	if (head)
+		return *head->element(0);
+	else
+		throw std::runtime_error("Stack is empty!\n"); /* Если запрашиваем элемент из пустого контейнера */
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+const Type& unrolled_list<Type, ChunkSize, Alloc>::front() const
+{
+	if (head)
+		return *head->element(0);
+	else
+		throw std::runtime_error("Stack is empty!\n"); /* Если запрашиваем элемент из пустого контейнера */
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+Type& unrolled_list<Type, ChunkSize, Alloc>::back()
+{
+	if (tail)
+		return *tail->element(tail->count - 1);
+	else
+		throw std::runtime_error("Stack is empty!\n"); /* Если запрашиваем элемент из пустого контейнера */
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+const Type& unrolled_list<Type, ChunkSize, Alloc>::back() const
+{
+	if (tail)
+		return *tail->element(tail->count - 1);
+	else
+		throw std::runtime_error("Stack is empty!\n"); /* Если запрашиваем элемент из пустого контейнера */
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+bool unrolled_list<Type, ChunkSize, Alloc>::empty() const noexcept
+{
+	return count == 0;
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+std::size_t unrolled_list<Type, ChunkSize, Alloc>::size() const noexcept
+{
+	return count;
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+void unrolled_list<Type, ChunkSize, Alloc>::clear() noexcept
+{
+	for (Node* temp = head; head; temp = head)
+	{
+		head = head->next;
+
+		for (std::size_t i = 0; i < temp->count; ++i)
+			AllocTraits::destroy(rebind_alloc, temp->element(i));
+		AllocTraits::destroy(rebind_alloc, temp);
+		AllocTraits::deallocate(rebind_alloc, temp, 1);
+	}
+	if (spare)
+	{
+		AllocTraits::destroy(rebind_alloc, spare);
+		AllocTraits::deallocate(rebind_alloc, spare, 1);
+		spare = nullptr;
+	}
+	tail = nullptr;
+	count = 0;
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+void unrolled_list<Type, ChunkSize, Alloc>::push_back(const Type& value)
+{
+	emplace_back(value);
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+void unrolled_list<Type, ChunkSize, Alloc>::push_back(Type&& value)
+{
+	emplace_back(std::move(value));
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+template<typename ...Args>
+void unrolled_list<Type, ChunkSize, Alloc>::emplace_back(Args&& ...args)
+{
+	if (tail && tail->count < ChunkSize) /* В хвостовом узле есть место */
+	{
+		AllocTraits::construct(rebind_alloc, tail->slot(tail->count), std::forward<Args>(args)...);
+		++tail->count;
+		++count;
+		return;
+	}
+
+	Node* temp = acquire_node();
+	try
+	{
+		AllocTraits::construct(rebind_alloc, temp->slot(0), std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		release_node(temp);
+		throw;
+	}
+	temp->count = 1;
+
+	if (tail) /* Подвешиваем новый узел за хвостом */
+	{
+		tail->next = temp;
+		temp->prev = tail;
+		tail = temp;
+	}
+	else
+	{
+		tail = temp;
+		head = tail;
+	}
+	++count;
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+void unrolled_list<Type, ChunkSize, Alloc>::pop_back() noexcept
+{
+	if (empty())
+		return;
+
+	AllocTraits::destroy(rebind_alloc, tail->element(tail->count - 1));
+	--count;
+	if (--tail->count != 0)
+		return;
+
+	Node* temp = tail; /* Узел опустел - отцепляем его */
+	tail = tail->prev;
+	if (tail)
+		tail->next = nullptr;
+	else
+		head = nullptr;
+
+	release_node(temp);
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+typename unrolled_list<Type, ChunkSize, Alloc>::Node* unrolled_list<Type, ChunkSize, Alloc>::acquire_node()
+{
+	if (spare)
+	{
+		Node* temp = spare;
+		spare = nullptr;
+		return temp;
+	}
+
+	Node* temp = AllocTraits::allocate(rebind_alloc, 1);
+	AllocTraits::construct(rebind_alloc, temp); /* Конструктор узла не бросает: элементы в нем не создаются */
+	return temp;
+}
+
+template<typename Type, std::size_t ChunkSize, typename Alloc>
+void unrolled_list<Type, ChunkSize, Alloc>::release_node(Node* node) noexcept
+{
+	node->count = 0;
+	node->prev = nullptr;
+	node->next = nullptr;
+	if (!spare)
+	{
+		spare = node;
+		return;
+	}
+
+	AllocTraits::destroy(rebind_alloc, node);
+	AllocTraits::deallocate(rebind_alloc, node, 1);
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,347 @@
+﻿#ifndef _work_stealing_pool_hpp
+#define _work_stealing_pool_hpp
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+*  Дек Чейза - Лева: локальный стек одного потока, из которого могут красть другие.
+*  Владелец кладет и снимает с вершины (LIFO) почти без синхронизации, воры забирают самый старый
+*  элемент со дна стека через CAS; гонка за последний элемент между владельцем и вором тоже решается CAS.
+*  Кольцевой буфер растет вдвое при заполнении; старые буферы живут до деструктора,
+*  потому что вор мог успеть прочитать указатель на них.
+*  Элементы хранятся в std::atomic<Type>, поэтому тип должен быть тривиально копируемым
+*  (указатель на задачу, индекс, небольшая структура).
+*  push и pop вызывает только поток-владелец, steal - любой поток.
+*/
+template<typename Type>
+class chase_lev_deque final
+{
+	static_assert(std::is_trivially_copyable_v<Type>, "chase_lev_deque requires trivially copyable elements");
+public:
+	/* Типы */
+	using value_type = Type;
+
+	/* Конструкторы и деструктор */
+	explicit chase_lev_deque(std::size_t capacity = 64); /* Начальная вместимость округляется вверх до степени двойки */
+	chase_lev_deque(const chase_lev_deque& oth) = delete;
+	chase_lev_deque(chase_lev_deque&& oth) = delete;
+	~chase_lev_deque() = default;
+
+	/* Операторы */
+	chase_lev_deque& operator=(const chase_lev_deque& oth) = delete;
+	chase_lev_deque& operator=(chase_lev_deque&& oth) = delete;
+	/* Методы */
+	bool empty() const noexcept; /* Снимок: к моменту возврата дек мог измениться */
+	std::size_t size() const noexcept; /* Снимок количества элементов */
+
+	void push(const Type& value); /* Владелец: кладет на вершину */
+	bool pop(Type& value) noexcept; /* Владелец: снимает с вершины; false, если пусто */
+	bool steal(Type& value) noexcept; /* Любой поток: забирает со дна; false, если пусто или проиграна гонка */
+private:
+	/* Кольцевой буфер, индексы берутся по маске */
+	struct Buffer final
+	{
+		std::size_t mask;
+		std::unique_ptr<std::atomic<Type>[]> slots;
+		std::unique_ptr<Buffer> previous; /* Буфер до роста, держим до деструктора */
+
+		explicit Buffer(std::size_t capacity)
+			: mask(capacity - 1),
+			slots(new std::atomic<Type>[capacity])
+		{}
+
+		Type get(std::int64_t index) const noexcept
+		{
+			return slots[static_cast<std::size_t>(index) & mask].load(std::memory_order_relaxed);
+		}
+
+		void put(std::int64_t index, const Type& value) noexcept
+		{
+			slots[static_cast<std::size_t>(index) & mask].store(value, std::memory_order_relaxed);
+		}
+	};
+
+	Buffer* grow(Buffer* buffer, std::int64_t bottom, std::int64_t top); /* Переезд в буфер вдвое больше */
+
+	/* Поля: вершину двигает владелец, дно - воры; разносим по разным строкам кэша */
+	alignas(64) std::atomic<std::int64_t> top{ 0 }; /* Дно стека, отсюда крадут */
+	alignas(64) std::atomic<std::int64_t> bottom{ 0 }; /* Вершина стека, за последним элементом */
+	std::atomic<Buffer*> buffer{ nullptr };
+	std::unique_ptr<Buffer> storage{}; /* Владеет текущим буфером и через previous - всеми старыми */
+};
+
+
+/*
+*  Пул задач с кражей работы: у каждого рабочего потока свой chase_lev_deque.
+*  Поток берет задачи со своей вершины (LIFO - свежие задачи горячие в кэше), а когда его стек пуст,
+*  крадет самые старые задачи у остальных, начиная с соседа.
+*  run запускает workers потоков и выполняет task(worker, item), пока не кончатся все задачи,
+*  включая порожденные: задача кладет новые через push(worker, ...), где worker - ее собственный номер.
+*/
+template<typename Type>
+class work_stealing_pool final
+{
+public:
+	/* Типы */
+	using value_type = Type;
+
+	/* Конструкторы и деструктор */
+	explicit work_stealing_pool(std::size_t workers = 0); /* 0 - по числу ядер */
+	work_stealing_pool(const work_stealing_pool& oth) = delete;
+	work_stealing_pool(work_stealing_pool&& oth) = delete;
+	~work_stealing_pool() = default;
+
+	/* Операторы */
+	work_stealing_pool& operator=(const work_stealing_pool& oth) = delete;
+	work_stealing_pool& operator=(work_stealing_pool&& oth) = delete;
+	/* Методы */
+	std::size_t workers() const noexcept; /* Количество рабочих потоков */
+	bool empty() const noexcept; /* Снимок: нет ни лежащих, ни выполняющихся задач */
+
+	void push(std::size_t worker, const Type& value); /* Кладет задачу в стек потока worker; вызывать из этого потока или до run */
+	bool pop(std::size_t worker, Type& value) noexcept; /* Своя задача, иначе краденая; false, если нигде ничего не нашлось */
+
+	template<typename Task>
+	void run(Task task); /* Выполняет задачи на workers() потоках до опустошения; при исключении задачи оставшиеся выбрасываются, оно пробрасывается */
+private:
+
+	void done() noexcept; /* Задача выполнена */
+	void discard() noexcept; /* Выбрасывает задачи, оставшиеся после неудачного run, чтобы пул можно было использовать снова */
+
+	std::vector<std::unique_ptr<chase_lev_deque<Type>>> deques{};
+	std::atomic<std::size_t> pending{ 0 }; /* Лежащие и выполняющиеся задачи */
+};
+
+
+template<typename Type>
+chase_lev_deque<Type>::chase_lev_deque(std::size_t capacity)
+{
+	std::size_t rounded = 1;
+	while (rounded < capacity)
+		rounded *= 2;
+	storage = std::make_unique<Buffer>(rounded);
+	buffer.store(storage.get(), std::memory_order_relaxed);
+}
+
+template<typename Type>
+bool chase_lev_deque<Type>::empty() const noexcept
+{
+	return size() == 0;
+}
+
+template<typename Type>
+std::size_t chase_lev_deque<Type>::size() const noexcept
+{
+	std::int64_t b = bottom.load(std::memory_order_relaxed);
+	std::int64_t t = top.load(std::memory_order_relaxed);
+	return b > t ? static_cast<std::size_t>(b - t) : 0;
+}
+
+template<typename Type>
+void chase_lev_deque<Type>::push(const Type& value)
+{
+	std::int64_t b = bottom.load(std::memory_order_relaxed);
+	std::int64_t t = top.load(std::memory_order_acquire);
+	Buffer* current = buffer.load(std::memory_order_relaxed);
+	if (b - t > static_cast<std::int64_t>(current->mask))
+		current = grow(current, b, t);
+
+	current->put(b, value);
+	std::atomic_thread_fence(std::memory_order_release); /* Вор, увидевший новое дно, видит и элемент */
+	bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+template<typename Type>
+bool chase_lev_deque<Type>::pop(Type& value) noexcept
+{
+	std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+	Buffer* current = buffer.load(std::memory_order_relaxed);
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst); /* Сначала занимаем элемент, потом смотрим на воров */
+	std::int64_t t = top.load(std::memory_order_relaxed);
+
+	if (t > b) /* Пусто */
+	{
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	Type candidate = current->get(b);
+	if (t == b) /* Последний элемент: за него может бороться вор */
+	{
+		bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		if (!won)
+			return false;
+	}
+	value = candidate;
+	return true;
+}
+
+template<typename Type>
+bool chase_lev_deque<Type>::steal(Type& value) noexcept
+{
+	std::int64_t t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	std::int64_t b = bottom.load(std::memory_order_acquire);
+	if (t >= b)
+		return false;
+
+	Buffer* current = buffer.load(std::memory_order_acquire);
+	Type candidate = current->get(t);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return false; /* Элемент забрал владелец или другой вор */
+
+	value = candidate;
+	return true;
+}
+
+template<typename Type>
+typename chase_lev_deque<Type>::Buffer* chase_lev_deque<Type>::grow(Buffer* current, std::int64_t b, std::int64_t t)
+{
+	auto bigger = std::make_unique<Buffer>((current->mask + 1) * 2);
+	for (std::int64_t i = t; i < b; ++i)
+		bigger->put(i, current->get(i));
+	bigger->previous = std::move(storage);
+	storage = std::move(bigger);
+
+	buffer.store(storage.get(), std::memory_order_release); /* Вор, прочитавший новый буфер, видит скопированные элементы */
+	return storage.get();
+}
+
+
+template<typename Type>
+work_stealing_pool<Type>::work_stealing_pool(std::size_t workers)
+{
+	if (workers == 0)
+		workers = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+	deques.reserve(workers);
+	for (std::size_t i = 0; i < workers; ++i)
+		deques.push_back(std::make_unique<chase_lev_deque<Type>>());
+}
+
+template<typename Type>
+std::size_t work_stealing_pool<Type>::workers() const noexcept
+{
+	return deques.size();
+}
+
+template<typename Type>
+bool work_stealing_pool<Type>::empty() const noexcept
+{
+	return pending.load(std::memory_order_acquire) == 0;
+}
+
+template<typename Type>
+void work_stealing_pool<Type>::push(std::size_t worker, const Type& value)
+{
+	pending.fetch_add(1, std::memory_order_relaxed); /* Счетчик растет раньше, чем задачу можно украсть */
+	try
+	{
+		deques[worker]->push(value);
+	}
+	catch (...)
+	{
+		done();
+		throw;
+	}
+}
+
+template<typename Type>
+bool work_stealing_pool<Type>::pop(std::size_t worker, Type& value) noexcept
+{
+	if (deques[worker]->pop(value))
+		return true;
+
+	for (std::size_t i = 1; i < deques.size(); ++i) /* Обходим остальных, начиная с соседа, чтобы воры не толпились у одного */
+		if (deques[(worker + i) % deques.size()]->steal(value))
+			return true;
+	return false;
+}
+
+template<typename Type>
+template<typename Task>
+void work_stealing_pool<Type>::run(Task task)
+{
+	std::exception_ptr error;
+	std::atomic<bool> failed{ false };
+	auto work = [&](std::size_t worker)
+	{
+		Type item;
+		while (!failed.load(std::memory_order_relaxed))
+		{
+			if (!pop(worker, item))
+			{
+				if (pending.load(std::memory_order_acquire) == 0) /* Ни лежащих, ни выполняющихся задач - новых не будет */
+					return;
+				std::this_thread::yield();
+				continue;
+			}
+
+			try
+			{
+				task(worker, item);
+			}
+			catch (...)
+			{
+				if (!failed.exchange(true))
+					error = std::current_exception(); /* Сохраняем первое исключение, остальные потоки останавливаются */
+			}
+			done();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(deques.size() - 1);
+	try
+	{
+		for (std::size_t i = 1; i < deques.size(); ++i)
+			threads.emplace_back(work, i);
+	}
+	catch (...)
+	{ /* Не смогли запустить поток - останавливаем и дожидаемся запущенных, иначе их деструктор вызовет terminate */
+		failed.store(true);
+		for (auto& thread : threads)
+			thread.join();
+		discard();
+		throw;
+	}
+	work(0); /* Нулевой рабочий - текущий поток */
+	for (auto& thread : threads)
+		thread.join();
+
+	if (error)
+	{
+		discard();
+		std::rethrow_exception(error);
+	}
+}
+
+template<typename Type>
+void work_stealing_pool<Type>::done() noexcept
+{
+	pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+template<typename Type>
+void work_stealing_pool<Type>::discard() noexcept
+{
+	/* Все рабочие потоки уже дождались, поэтому каждый дек опустошаем как владелец */
+	Type item;
+	for (auto& deque : deques)
+		while (deque->pop(item))
+			;
+	pending.store(0, std::memory_order_release);
+}
+
+
+#endif
\ No newline at end of file